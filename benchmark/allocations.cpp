@@ -0,0 +1,239 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <chronicle/binary_log.hpp>
+#include <chronicle/sinks/file.hpp>
+#include <chronicle/structured_log.hpp>
+#include <chronicle/text_log.hpp>
+
+
+// Counts heap allocations made by producer threads and by the rest of
+// the process (the backend) per logged message, after every queue slot
+// and callsite was used once. Exits with 1 if a producer allocated in
+// steady state.
+
+
+struct settings {
+    static constexpr unsigned queue_size = 1024;
+    static constexpr std::size_t callsites = 400;
+    // More than fit the initial literal table of chronicle::callsites
+    static constexpr std::size_t overflow_callsites = 10000;
+    static constexpr auto warmup_messages = 2 * overflow_callsites;
+    static constexpr auto messages = 100000;
+    static constexpr auto int_number = 127562;
+    static constexpr auto string = std::string_view {"benchmark"};
+    static constexpr auto float_number = 3.14;
+    static constexpr auto path = "test.log";
+};
+
+
+// Literal text of a distinct callsite, "c000 ", "c001 ", ...
+template<std::size_t I>
+struct callsite_text {
+    static constexpr char text[] = {'c',
+                                    char('0' + I / 100 % 10),
+                                    char('0' + I / 10 % 10),
+                                    char('0' + I % 10),
+                                    ' ',
+                                    '\0'};
+};
+
+
+// Distinct arrays are distinct callsites, "o00000 ", "o00001 ", ...
+auto make_overflow_texts() {
+    auto* texts = new char[settings::overflow_callsites][8];
+    for(std::size_t i = 0; i != settings::overflow_callsites; ++i)
+        std::snprintf(texts[i], sizeof(texts[i]), "o%05zu ", i);
+    return texts;
+}
+
+
+template<class Log, std::size_t... I>
+auto make_callsites(std::index_sequence<I...>) {
+    return std::array<void (*)(Log&), sizeof...(I)> {[](Log& log) {
+        log.info("benchmark", callsite_text<I>::text, settings::int_number);
+    }...};
+}
+
+
+thread_local bool is_producer = false;
+std::atomic<std::uint64_t> producer_allocations {0};
+std::atomic<std::uint64_t> other_allocations {0};
+
+
+void count_allocation() noexcept {
+    if(is_producer)
+        producer_allocations.fetch_add(1, std::memory_order_relaxed);
+    else
+        other_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+#if defined(__GLIBC__)
+
+// Direct malloc calls are counted as well, operator new is counted there
+extern "C" void* __libc_malloc(std::size_t);
+extern "C" void* __libc_calloc(std::size_t, std::size_t);
+extern "C" void* __libc_realloc(void*, std::size_t);
+
+extern "C" void* malloc(std::size_t size) {
+    count_allocation();
+    return __libc_malloc(size);
+}
+
+
+extern "C" void* calloc(std::size_t n, std::size_t size) {
+    count_allocation();
+    return __libc_calloc(n, size);
+}
+
+
+extern "C" void* realloc(void* p, std::size_t size) {
+    count_allocation();
+    return __libc_realloc(p, size);
+}
+
+#    define COUNT_NEW()
+
+#else
+
+#    define COUNT_NEW() count_allocation()
+
+#endif
+
+
+void* allocate(std::size_t size) {
+    COUNT_NEW();
+    if(void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc {};
+}
+
+
+void* allocate(std::size_t size, std::align_val_t alignment) {
+    count_allocation();
+    auto const a = std::size_t(alignment);
+    if(void* p = std::aligned_alloc(a, (size + a - 1) / a * a))
+        return p;
+    throw std::bad_alloc {};
+}
+
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t a) {
+    return allocate(size, a);
+}
+void* operator new[](std::size_t size, std::align_val_t a) {
+    return allocate(size, a);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+
+
+
+// Returns true if producer didn't allocate after warm-up
+template<class Log, typename F>
+bool run_benchmark(char const* name, F&& f) {
+    std::filesystem::remove(settings::path);
+    std::uint64_t producer = 0, other = 0;
+    {
+        Log log;
+        if(!log.open(chronicle::sinks::file::open(settings::path),
+                     settings::queue_size))
+            return false;
+        std::thread {[&] {
+            is_producer = true;
+            for(unsigned i = 0; i != settings::warmup_messages; ++i)
+                f(log);
+            log.flush();
+            producer_allocations.store(0);
+            other_allocations.store(0);
+            for(int i = 0; i != settings::messages; ++i)
+                f(log);
+        }}.join();
+        log.close();
+        producer = producer_allocations.load();
+        other = other_allocations.load();
+    }
+    std::filesystem::remove(settings::path);
+    std::printf("%-18s %12.4f %12.4f%s\n",
+                name,
+                double(producer) / settings::messages,
+                double(other) / settings::messages,
+                producer != 0 ? "  FAILED" : "");
+    return producer == 0;
+}
+
+
+int main() {
+    std::printf("Allocations per message\n");
+    std::printf("%-18s %12s %12s\n", "log", "producer", "backend");
+    auto ok = true;
+
+    ok &= run_benchmark<chronicle::unique_text_log>(
+        "unique_text_log", [](auto& log) {
+            log.info("benchmark", "Logging ", settings::string,
+                     ' ', settings::int_number, ' ', settings::float_number);
+        });
+
+    ok &= run_benchmark<chronicle::shared_text_log>(
+        "shared_text_log", [](auto& log) {
+            log.info("benchmark", "Logging ", settings::string,
+                     ' ', settings::int_number, ' ', settings::float_number);
+        });
+
+    // Called round-robin, more callsites than fit any small cache
+    ok &= run_benchmark<chronicle::shared_text_log>(
+        "many_callsites", [](auto& log) {
+            using log_type = std::remove_reference_t<decltype(log)>;
+            static auto const calls = make_callsites<log_type>(
+                std::make_index_sequence<settings::callsites> {});
+            static std::size_t next = 0;
+            calls[next++ % calls.size()](log);
+        });
+
+    ok &= run_benchmark<chronicle::shared_text_log>(
+        "overflow_callsites", [](auto& log) {
+            static auto const* const texts = make_overflow_texts();
+            static std::size_t next = 0;
+            log.info("benchmark",
+                     texts[next++ % settings::overflow_callsites],
+                     settings::int_number);
+        });
+
+    ok &= run_benchmark<chronicle::shared_structured_log>(
+        "structured_log", [](auto& log) {
+            log.info("benchmark", "Logging",
+                     "string", settings::string,
+                     "int", settings::int_number,
+                     "float", settings::float_number);
+        });
+
+    ok &= run_benchmark<chronicle::shared_binary_log>(
+        "binary_log", [](auto& log) {
+            log.info("benchmark", "Logging ", settings::string,
+                     ' ', settings::int_number, ' ', settings::float_number);
+        });
+
+    return ok ? 0 : 1;
+}
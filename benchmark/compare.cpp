@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <ufmt/print.hpp>
+
+#include "report.hpp"
+
+
+// Compares benchmark runs written with '--json' against a baseline:
+//   chronicle-compare [-t tolerance %] baseline.json current.json...
+// Each metric of several runs is their median. Exits with 1 if any metric
+// is worse than the baseline by more than the tolerance (10% by default)
+// or is missing from the runs. With '-m' the median of the runs is
+// written as a baseline instead:
+//   chronicle-compare -m baseline.json current.json...
+
+
+struct metric {
+    std::string name;
+    double value {0.};
+    std::string unit;
+    bool lower_is_better {true};
+};   // metric
+
+
+// Just enough JSON to read files written by report.hpp
+class json_reader {
+    std::string_view in_;
+
+public:
+    explicit json_reader(std::string_view in) noexcept: in_ {in} {}
+
+
+    std::optional<std::vector<metric>> metrics(std::string& benchmark) {
+        std::vector<metric> result;
+        auto const parsed = object([&](std::string const& key) {
+            if(key == "benchmark")
+                return string(benchmark);
+            if(key != "metrics")
+                return skip_value();
+            return array([&] {
+                metric m;
+                std::string better = "lower";
+                auto const ok = object([&](std::string const& field) {
+                    if(field == "name")
+                        return string(m.name);
+                    if(field == "value")
+                        return number(m.value);
+                    if(field == "unit")
+                        return string(m.unit);
+                    if(field == "better")
+                        return string(better);
+                    return skip_value();
+                });
+                m.lower_is_better = better != "higher";
+                result.push_back(std::move(m));
+                return ok;
+            });
+        });
+        if(!parsed)
+            return std::nullopt;
+        return result;
+    }
+
+private:
+    void skip_spaces() noexcept {
+        while(!in_.empty()
+              && (in_[0] == ' ' || in_[0] == '\n' || in_[0] == '\r'
+                  || in_[0] == '\t'))
+            in_.remove_prefix(1);
+    }
+
+
+    bool consume(char c) noexcept {
+        skip_spaces();
+        if(in_.empty() || in_[0] != c)
+            return false;
+        in_.remove_prefix(1);
+        return true;
+    }
+
+
+    template<typename F>
+    bool object(F&& member) {
+        if(!consume('{'))
+            return false;
+        if(consume('}'))
+            return true;
+        do {
+            std::string key;
+            if(!string(key) || !consume(':') || !member(key))
+                return false;
+        } while(consume(','));
+        return consume('}');
+    }
+
+
+    template<typename F>
+    bool array(F&& element) {
+        if(!consume('['))
+            return false;
+        if(consume(']'))
+            return true;
+        do {
+            if(!element())
+                return false;
+        } while(consume(','));
+        return consume(']');
+    }
+
+
+    bool string(std::string& out) {
+        if(!consume('"'))
+            return false;
+        out.clear();
+        while(!in_.empty() && in_[0] != '"') {
+            if(in_[0] == '\\' && in_.size() > 1)
+                in_.remove_prefix(1);
+            out += in_[0];
+            in_.remove_prefix(1);
+        }
+        return consume('"');
+    }
+
+
+    bool number(double& out) {
+        skip_spaces();
+        auto const text = std::string {in_.substr(0, 32)};
+        char* end = nullptr;
+        out = std::strtod(text.c_str(), &end);
+        if(end == text.c_str())
+            return false;
+        in_.remove_prefix(std::size_t(end - text.c_str()));
+        return true;
+    }
+
+
+    bool skip_value() {
+        skip_spaces();
+        if(in_.empty())
+            return false;
+        std::string ignored;
+        double number_ignored;
+        switch(in_[0]) {
+        case '"':
+            return string(ignored);
+        case '{':
+            return object([&](std::string const&) { return skip_value(); });
+        case '[':
+            return array([&] { return skip_value(); });
+        default:
+            for(auto const word: {"true", "false", "null"})
+                if(in_.starts_with(word)) {
+                    in_.remove_prefix(std::string_view {word}.size());
+                    return true;
+                }
+            return number(number_ignored);
+        }
+    }
+
+};   // json_reader
+
+
+std::optional<std::vector<metric>> read_metrics(char const* path,
+                                                std::string& benchmark) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+        return std::nullopt;
+    auto const contents = std::string {std::istreambuf_iterator<char>(file),
+                                       std::istreambuf_iterator<char>()};
+    return json_reader {contents}.metrics(benchmark);
+}
+
+
+// Metrics in order of the first run, each the median over runs having it
+std::vector<metric> median(std::vector<std::vector<metric>> const& runs) {
+    std::vector<metric> result;
+    std::unordered_map<std::string_view, std::vector<double>> values;
+    for(auto const& run: runs)
+        for(auto const& m: run) {
+            auto& v = values[m.name];
+            if(v.empty())
+                result.push_back(m);
+            v.push_back(m.value);
+        }
+    for(auto& m: result) {
+        auto& v = values[m.name];
+        std::sort(v.begin(), v.end());
+        auto const n = v.size();
+        m.value = n % 2 == 1 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.;
+    }
+    return result;
+}
+
+
+int main(int argc, char** argv) {
+    double tolerance = 10.;
+    char const* median_path = nullptr;
+    std::vector<char const*> paths;
+
+    for(int i = 1; i != argc; ++i) {
+        auto const option = std::string_view {argv[i]};
+        if(option == "-t" && i + 1 != argc)
+            tolerance = std::atof(argv[++i]);
+        else if(option == "-m" && i + 1 != argc)
+            median_path = argv[++i];
+        else if(!option.empty() && option[0] == '-')
+            return ufmt::error_with(-1, "error: unknown option ", option);
+        else
+            paths.push_back(argv[i]);
+    }
+    if(paths.size() < (median_path ? 1u : 2u))
+        return ufmt::error_with(-1,
+                                "usage: chronicle-compare [-t tolerance %] "
+                                "baseline.json current.json...\n"
+                                "       chronicle-compare -m baseline.json "
+                                "current.json...");
+
+    std::string benchmark;
+    std::optional<std::vector<metric>> baseline;
+    if(!median_path) {
+        baseline = read_metrics(paths[0], benchmark);
+        if(!baseline)
+            return ufmt::error_with(-1, "error: unable to read ",
+                                    std::string_view {paths[0]});
+        paths.erase(paths.begin());
+    }
+    std::vector<std::vector<metric>> runs;
+    for(auto const* path: paths) {
+        auto run = read_metrics(path, benchmark);
+        if(!run)
+            return ufmt::error_with(-1, "error: unable to read ",
+                                    std::string_view {path});
+        runs.push_back(std::move(*run));
+    }
+    auto const current = median(runs);
+
+    if(median_path) {
+        report written {benchmark};
+        for(auto const& m: current)
+            written.add(m.name,
+                        m.value,
+                        m.unit,
+                        m.lower_is_better ? report::better::lower
+                                          : report::better::higher);
+        if(!written.write(median_path))
+            return ufmt::error_with(-1, "error: unable to write ",
+                                    std::string_view {median_path});
+        return 0;
+    }
+
+    std::unordered_map<std::string_view, metric const*> measured;
+    for(auto const& m: current)
+        measured.emplace(m.name, &m);
+
+    auto regressions = 0;
+    std::printf("%-32s %14s %14s %9s\n", "metric", "baseline", "current", "change");
+    for(auto const& base: *baseline) {
+        auto const it = measured.find(base.name);
+        if(it == measured.end()) {
+            std::printf("%-32s %14.2f %14s %9s  missing\n",
+                        base.name.c_str(), base.value, "-", "-");
+            ++regressions;
+            continue;
+        }
+        auto const value = it->second->value;
+        auto const change = base.value != 0.
+                              ? (value - base.value) / std::fabs(base.value) * 100.
+                              : 0.;
+        auto const worse = base.lower_is_better ? change : -change;
+        auto const status = worse > tolerance     ? "  REGRESSION"
+                            : worse < -tolerance ? "  improved"
+                                                 : "";
+        if(worse > tolerance)
+            ++regressions;
+        std::printf("%-32s %14.2f %14.2f %+8.1f%%%s\n",
+                    base.name.c_str(), base.value, value, change, status);
+    }
+    std::printf("%d of %zu metrics regressed by more than %.1f%%\n",
+                regressions, baseline->size(), tolerance);
+    return regressions == 0 ? 0 : 1;
+}
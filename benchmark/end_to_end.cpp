@@ -0,0 +1,123 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "histogram.hpp"
+
+#include <chronicle/cheap_clock.hpp>
+#include <chronicle/data_log.hpp>
+#include <chronicle/sink.hpp>
+
+
+// Latency from a logging call to the moment its batch is handed to
+// sink::write for each burst size. The backend sleeps between bursts, so
+// every burst includes waking it up. Every message carries the time stamp
+// counter value of its call, the sink takes it back from formatted data.
+
+
+struct settings {
+    static constexpr auto total_messages = 20000;
+    static constexpr unsigned burst_sizes[] = {1, 16, 256};
+    static constexpr auto pause = std::chrono::microseconds {100};
+};
+
+
+struct probe {
+    std::uint64_t sent;
+};
+
+
+// Writes raw time stamps only
+struct probe_format {
+    template<class DF, class S, typename D, class TimePoint>
+    void print(chronicle::message<D, TimePoint> const& m,
+               ufmt::basic_text<S>& text) {
+        text.append(reinterpret_cast<char const*>(&m.data.sent),
+                    sizeof(m.data.sent));
+    }
+};
+
+
+using probe_log = chronicle::data_log<
+    chronicle::traits_shared<probe, probe_format, std::chrono::system_clock>>;
+
+
+class stamping_sink: public chronicle::sink {
+    chronicle::cheap_clock const& clock_;
+    histogram& latencies_;
+    histogram& batches_;
+
+public:
+    stamping_sink(chronicle::cheap_clock const& clock,
+                  histogram& latencies,
+                  histogram& batches) noexcept
+        : clock_ {clock}, latencies_ {latencies}, batches_ {batches} {}
+
+
+    bool ready() const noexcept override { return true; }
+
+
+    void write(time_point const&,
+               char const* data,
+               size_type size) noexcept override {
+        auto const now = chronicle::cheap_clock::ticks();
+        auto const count = size / sizeof(std::uint64_t);
+        for(size_type i = 0; i != count; ++i) {
+            std::uint64_t sent;
+            std::memcpy(&sent, data + i * sizeof(sent), sizeof(sent));
+            latencies_.add(clock_.nanoseconds(now - sent));
+        }
+        if(count != 0)
+            batches_.add(count);
+    }
+
+
+    void flush() noexcept override {}
+    void close() noexcept override {}
+    void prologue(char const*, size_t) noexcept override {}
+    void epilogue(char const*, size_t) noexcept override {}
+
+};   // stamping_sink
+
+
+void run_benchmark(chronicle::cheap_clock const& clock,
+                   unsigned burst_size) {
+    histogram latencies, batches;
+    {
+        probe_log log {sizeof(std::uint64_t)};
+        if(!log.open(chronicle::sink_ptr {
+               new stamping_sink {clock, latencies, batches}}))
+            return;
+        for(unsigned i = 0; i != settings::total_messages / burst_size; ++i) {
+            for(unsigned j = 0; j != burst_size; ++j)
+                log.info("benchmark",
+                         "probe",
+                         probe {chronicle::cheap_clock::ticks()});
+            std::this_thread::sleep_for(settings::pause);
+        }
+    }
+    std::printf("%6u %9llu %9llu %9llu %9llu %10llu %7llu\n",
+                burst_size,
+                (unsigned long long)latencies.percentile(50.),
+                (unsigned long long)latencies.percentile(90.),
+                (unsigned long long)latencies.percentile(99.),
+                (unsigned long long)latencies.percentile(99.9),
+                (unsigned long long)latencies.max(),
+                (unsigned long long)batches.percentile(50.));
+}
+
+
+int main() {
+    chronicle::cheap_clock clock;
+    clock.calibrate(std::chrono::milliseconds {100});
+    std::printf("Call to sink::write latency, nanoseconds\n");
+    std::printf("%6s %9s %9s %9s %9s %10s %7s\n",
+                "burst", "p50", "p90", "p99", "p99.9", "max", "batch");
+    for(auto const burst_size: settings::burst_sizes)
+        run_benchmark(clock, burst_size);
+    std::printf("'batch' is the median number of messages in sink::write\n");
+    return 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+
+// Log-bucketed histogram of values in nanoseconds, as HdrHistogram with
+// 5 bits of sub-bucket precision: values are kept within 3%
+class histogram {
+    static constexpr unsigned sub_bits = 5;
+    static constexpr std::uint64_t sub_count = 1u << sub_bits;
+    static constexpr std::size_t buckets_count = (65 - sub_bits) * sub_count;
+
+    std::array<std::uint64_t, buckets_count> counts_ {};
+    std::uint64_t total_ {0};
+    std::uint64_t max_ {0};
+
+public:
+    static std::size_t index_of(std::uint64_t value) noexcept {
+        if(value < sub_count)
+            return std::size_t(value);
+        auto const shift = unsigned(std::bit_width(value)) - 1 - sub_bits;
+        return std::size_t((shift + 1) * sub_count
+                           + (value >> shift) - sub_count);
+    }
+
+
+    // Upper bound of values counted by 'index'
+    static std::uint64_t value_at(std::size_t index) noexcept {
+        if(index < sub_count)
+            return index;
+        auto const shift = unsigned(index / sub_count - 1);
+        auto const sub = index % sub_count + sub_count;
+        return ((sub + 1) << shift) - 1;
+    }
+
+
+    void add(std::uint64_t value) noexcept {
+        ++counts_[index_of(value)];
+        ++total_;
+        if(value > max_)
+            max_ = value;
+    }
+
+
+    void merge(histogram const& other) noexcept {
+        for(std::size_t i = 0; i != buckets_count; ++i)
+            counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        if(other.max_ > max_)
+            max_ = other.max_;
+    }
+
+
+    void clear() noexcept {
+        counts_.fill(0);
+        total_ = 0;
+        max_ = 0;
+    }
+
+
+    std::uint64_t total() const noexcept { return total_; }
+    std::uint64_t max() const noexcept { return max_; }
+
+
+    // 'p' is from 0 to 100
+    std::uint64_t percentile(double p) const noexcept {
+        if(total_ == 0)
+            return 0;
+        auto const rank = std::uint64_t(p / 100. * double(total_) + 0.5);
+        auto const target = rank == 0 ? 1 : rank;
+        std::uint64_t seen = 0;
+        for(std::size_t i = 0; i != buckets_count; ++i) {
+            seen += counts_[i];
+            if(seen >= target)
+                return value_at(i) < max_ ? value_at(i) : max_;
+        }
+        return max_;
+    }
+
+};   // histogram
@@ -0,0 +1,206 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "histogram.hpp"
+#include "perf_counters.hpp"
+#include "report.hpp"
+
+#include <chronicle/cheap_clock.hpp>
+#include <chronicle/sinks/file.hpp>
+#include <chronicle/text_log.hpp>
+
+#include <NanoLog.hpp>
+
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/spdlog.h>
+
+
+// Latency of every logging call, timed with the time stamp counter and
+// reported as percentiles for 1 to 16 producer threads, followed by
+// hardware counters of producer threads per message. Median of chronicle
+// is written as JSON with '--json path'.
+
+
+struct settings {
+    static constexpr auto messages_per_thread = 100000;
+    static constexpr auto warmup_messages = 1000;
+    static constexpr auto int_number = 127562;
+    static constexpr auto string = std::string_view {"benchmark"};
+    static constexpr auto float_number = 3.14;
+    static constexpr unsigned thread_counts[] = {1, 2, 4, 8, 16};
+};
+
+
+chronicle::shared_text_log chronicle_logger;
+std::shared_ptr<spdlog::logger> spd_logger;
+
+
+struct result {
+    histogram latencies;
+    perf_counters::values counters;
+};
+
+
+template<typename F>
+result run_benchmark(chronicle::cheap_clock const& clock,
+                     unsigned thread_count,
+                     F&& f) {
+    std::vector<result> results(thread_count);
+    std::vector<std::thread> threads;
+
+    auto benchmark = [&](result& r) {
+        perf_counters counters;
+        for(int i = 0; i != settings::warmup_messages; ++i)
+            f();
+        counters.start();
+        for(int i = 0; i != settings::messages_per_thread; ++i) {
+            auto const begin = chronicle::cheap_clock::ticks();
+            f();
+            auto const end = chronicle::cheap_clock::ticks();
+            r.latencies.add(clock.nanoseconds(end - begin));
+        }
+        r.counters = counters.stop();
+    };
+
+    for(unsigned i = 0; i != thread_count; ++i)
+        threads.emplace_back(benchmark, std::ref(results[i]));
+    for(auto& t: threads)
+        t.join();
+
+    result total;
+    for(auto const& r: results) {
+        total.latencies.merge(r.latencies);
+        total.counters += r.counters;
+    }
+    return total;
+}
+
+
+void print_header() {
+    std::printf("%-10s %7s %8s %8s %8s %8s %8s %10s\n",
+                "logger", "threads", "p50", "p90", "p99", "p99.9", "p99.99",
+                "max");
+}
+
+
+void print_row(char const* name, unsigned threads, histogram const& h) {
+    std::printf("%-10s %7u %8llu %8llu %8llu %8llu %8llu %10llu\n",
+                name,
+                threads,
+                (unsigned long long)h.percentile(50.),
+                (unsigned long long)h.percentile(90.),
+                (unsigned long long)h.percentile(99.),
+                (unsigned long long)h.percentile(99.9),
+                (unsigned long long)h.percentile(99.99),
+                (unsigned long long)h.max());
+}
+
+
+void print_counters_header() {
+    std::printf("%-10s %7s %9s", "logger", "threads", "wall_ns");
+    for(std::size_t i = 0; i != perf_counters::count; ++i)
+        std::printf(" %16s", perf_counters::name(i));
+    std::printf("\n");
+}
+
+
+void print_counters(char const* name,
+                    unsigned threads,
+                    perf_counters::values const& v) {
+    auto const messages = double(settings::messages_per_thread) * threads;
+    std::printf("%-10s %7u %9.1f",
+                name,
+                threads,
+                double(v.wall.count()) / messages);
+    for(std::size_t i = 0; i != perf_counters::count; ++i)
+        if(v.available[i])
+            std::printf(" %16.3f", double(v.counters[i]) / messages);
+        else
+            std::printf(" %16s", "n/a");
+    std::printf("\n");
+}
+
+
+struct row {
+    char const* name;
+    unsigned threads;
+    perf_counters::values counters;
+};
+
+
+int main(int argc, char** argv) {
+    if(!chronicle_logger.open(chronicle::sinks::file::open("test.log"),
+                              128 * 1024)) {
+        std::puts("Unable to open log");
+        return 1;
+    }
+
+    nanolog::initialize(nanolog::GuaranteedLogger(), "", "nanolog", 1);
+
+    spdlog::init_thread_pool(128 * 1024, 1);
+    spd_logger = spdlog::basic_logger_mt<spdlog::async_factory>("spdlog",
+                                                                "spd.log",
+                                                                true);
+    spd_logger->set_pattern("[%l] %v");
+
+    chronicle::cheap_clock clock;
+    clock.calibrate(std::chrono::milliseconds {100});
+    std::printf("Latency of a call, nanoseconds\n");
+    print_header();
+
+    std::vector<row> rows;
+    report json {"latency"};
+    auto const record = [&](char const* name, unsigned threads, result r) {
+        print_row(name, threads, r.latencies);
+        rows.push_back({name, threads, r.counters});
+        if(name != std::string_view {"chronicle"})
+            return;
+        // Higher percentiles are too noisy to compare between runs
+        json.add(std::string {name} + '/' + std::to_string(threads) + "/p50",
+                 double(r.latencies.percentile(50.)),
+                 "ns",
+                 report::better::lower);
+    };
+
+    for(auto const threads: settings::thread_counts) {
+        record("chronicle", threads, run_benchmark(clock, threads, [] {
+            chronicle_logger.info("benchmark",
+                                  "Logging ", settings::string,
+                                  ' ', settings::int_number,
+                                  ' ', settings::float_number);
+        }));
+
+        record("nanolog", threads, run_benchmark(clock, threads, [] {
+            LOG_INFO << "Logging " << settings::string.data()
+                     << ' ' << settings::int_number
+                     << ' ' << settings::float_number;
+        }));
+
+        record("spdlog", threads, run_benchmark(clock, threads, [] {
+            spd_logger->info("Logging {} {} {}",
+                             settings::string,
+                             settings::int_number,
+                             settings::float_number);
+        }));
+    }
+
+    std::printf("\nProducer counters per message\n");
+    print_counters_header();
+    for(auto const& r: rows)
+        print_counters(r.name, r.threads, r.counters);
+
+    std::printf("chronicle blocks: %llu\n",
+                (unsigned long long)chronicle_logger.blocks_count());
+
+    auto const json_path = report::json_path(argc, argv);
+    if(json_path && !json.write(json_path)) {
+        std::printf("Unable to write %s\n", json_path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+
+// Hardware counters of the calling thread read with perf_event_open.
+// They are opened as one group, so the kernel schedules them together and
+// ratios stay meaningful; counts are scaled by enabled / running time if
+// the group was multiplexed. Counters the kernel refuses to open (no PMU,
+// perf_event_paranoid, other systems) or that never ran are reported as
+// unavailable, wall time is always there.
+class perf_counters {
+public:
+    static constexpr std::size_t count = 6;
+
+    struct values {
+        std::array<std::uint64_t, count> counters {};
+        std::array<bool, count> available {};
+        std::chrono::nanoseconds wall {0};
+
+
+        values& operator+=(values const& other) noexcept {
+            for(std::size_t i = 0; i != count; ++i) {
+                counters[i] += other.counters[i];
+                available[i] = available[i] || other.available[i];
+            }
+            wall += other.wall;
+            return *this;
+        }
+    };   // values
+
+
+    static char const* name(std::size_t i) noexcept {
+        constexpr char const* names[count] = {
+            "cycles", "instructions", "l1d_misses",
+            "llc_misses", "branch_misses", "context_switches"};
+        return names[i];
+    }
+
+private:
+    std::array<int, count> fds_;
+    int leader_ {-1};
+    std::chrono::steady_clock::time_point started_;
+
+public:
+    perf_counters() noexcept {
+        fds_.fill(-1);
+#if defined(__linux__)
+        constexpr std::uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        struct event {
+            std::uint32_t type;
+            std::uint64_t config;
+        };
+        constexpr event events[count] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, l1d_read_miss},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES}};
+        for(std::size_t i = 0; i != count; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[i].type;
+            attr.config = events[i].config;
+            attr.disabled = leader_ == -1;
+            attr.exclude_kernel = events[i].type != PERF_TYPE_SOFTWARE;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP
+                | PERF_FORMAT_TOTAL_TIME_ENABLED
+                | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[i] =
+                int(::syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+            if(leader_ == -1)
+                leader_ = fds_[i];
+        }
+#endif
+    }
+
+
+    perf_counters(perf_counters const&) = delete;
+    perf_counters& operator=(perf_counters const&) = delete;
+
+
+    ~perf_counters() {
+#if defined(__linux__)
+        for(auto const fd: fds_)
+            if(fd != -1)
+                ::close(fd);
+#endif
+    }
+
+
+    void start() noexcept {
+#if defined(__linux__)
+        if(leader_ != -1) {
+            ::ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ::ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+        started_ = std::chrono::steady_clock::now();
+    }
+
+
+    values stop() noexcept {
+        values v;
+        v.wall = std::chrono::steady_clock::now() - started_;
+#if defined(__linux__)
+        if(leader_ == -1)
+            return v;
+        ::ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // Members follow the leader in the order they were opened
+        struct {
+            std::uint64_t members;
+            std::uint64_t enabled;
+            std::uint64_t running;
+            std::uint64_t values[count];
+        } group;
+        auto const size = ::read(leader_, &group, sizeof(group));
+        if(size < 3 * ssize_t(sizeof(std::uint64_t)) || group.running == 0)
+            return v;
+        auto const scale = double(group.enabled) / double(group.running);
+        std::size_t member = 0;
+        for(std::size_t i = 0; i != count && member != group.members; ++i) {
+            if(fds_[i] == -1)
+                continue;
+            v.counters[i] =
+                std::uint64_t(double(group.values[member++]) * scale + 0.5);
+            v.available[i] = true;
+        }
+#endif
+        return v;
+    }
+
+};   // perf_counters
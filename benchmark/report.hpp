@@ -0,0 +1,73 @@
+#pragma once
+
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+// Results of a benchmark run written as JSON for 'chronicle-compare':
+//   {"benchmark": "latency", "metrics": [
+//     {"name": "chronicle/1/p50", "value": 120, "unit": "ns", "better": "lower"}]}
+class report {
+public:
+    enum class better { lower, higher };
+
+private:
+    struct metric {
+        std::string name;
+        double value;
+        std::string unit;
+        better direction;
+    };   // metric
+
+    std::string benchmark_;
+    std::vector<metric> metrics_;
+
+public:
+    explicit report(std::string benchmark) noexcept
+        : benchmark_ {std::move(benchmark)} {}
+
+
+    void add(std::string name,
+             double value,
+             std::string unit,
+             better direction) {
+        metrics_.push_back(
+            {std::move(name), value, std::move(unit), direction});
+    }
+
+
+    bool write(char const* path) const {
+        auto* file = std::fopen(path, "wb");
+        if(!file)
+            return false;
+        std::fprintf(file, "{\n  \"benchmark\": \"%s\",\n  \"metrics\": [",
+                     benchmark_.c_str());
+        for(std::size_t i = 0; i != metrics_.size(); ++i) {
+            auto const& m = metrics_[i];
+            std::fprintf(file,
+                         "%s\n    {\"name\": \"%s\", \"value\": %.6f, "
+                         "\"unit\": \"%s\", \"better\": \"%s\"}",
+                         i == 0 ? "" : ",",
+                         m.name.c_str(),
+                         m.value,
+                         m.unit.c_str(),
+                         m.direction == better::lower ? "lower" : "higher");
+        }
+        std::fprintf(file, "\n  ]\n}\n");
+        return std::fclose(file) == 0;
+    }
+
+
+    // Path given with '--json path' or null
+    static char const* json_path(int argc, char** argv) noexcept {
+        for(int i = 1; i + 1 < argc; ++i)
+            if(std::string_view {argv[i]} == "--json")
+                return argv[i + 1];
+        return nullptr;
+    }
+
+};   // report
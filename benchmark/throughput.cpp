@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "report.hpp"
+
+#include <chronicle/sinks/file.hpp>
+#include <chronicle/text_log.hpp>
+
+
+// Sustained throughput from producers calling the log as fast as they can
+// until everything is written, for every queue size, message size and
+// thread count. Producers block when the queue is full, so the point
+// where blocks appear is the capacity of the backend. Messages per
+// second are written as JSON with '--json path'.
+
+
+struct settings {
+    static constexpr auto total_messages = 400000;
+    static constexpr unsigned queue_sizes[] = {1024, 8192, 65536, 262144};
+    static constexpr std::size_t message_sizes[] = {16, 64, 256};
+    static constexpr unsigned thread_counts[] = {1, 2, 4, 8};
+    static constexpr auto path = "test.log";
+};
+
+
+struct result {
+    double messages_per_second;
+    double bytes_per_second;
+    std::uint64_t blocks;
+};
+
+
+result run_benchmark(unsigned queue_size,
+                     std::string_view payload,
+                     unsigned thread_count) {
+    using namespace std::chrono;
+    std::filesystem::remove(settings::path);
+    chronicle::shared_text_log log;
+    if(!log.open(chronicle::sinks::file::open(settings::path), queue_size))
+        return {};
+
+    auto const iterations = settings::total_messages / thread_count;
+    std::vector<std::thread> threads;
+    auto const begin = steady_clock::now();
+    for(unsigned i = 0; i != thread_count; ++i)
+        threads.emplace_back([&] {
+            for(unsigned j = 0; j != iterations; ++j)
+                log.info("benchmark", "Logging ", payload, ' ', j);
+        });
+    for(auto& t: threads)
+        t.join();
+    auto const blocks = log.blocks_count();
+    log.close();
+    auto const elapsed = duration<double>(steady_clock::now() - begin);
+
+    auto const bytes = std::filesystem::file_size(settings::path);
+    std::filesystem::remove(settings::path);
+    auto const messages = double(iterations) * thread_count;
+    return {messages / elapsed.count(),
+            double(bytes) / elapsed.count(),
+            std::uint64_t(blocks)};
+}
+
+
+int main(int argc, char** argv) {
+    report json {"throughput"};
+    std::printf("%10s %8s %7s %12s %10s %10s\n",
+                "queue", "payload", "threads", "messages/s", "MiB/s", "blocks");
+    for(auto const queue_size: settings::queue_sizes)
+        for(auto const message_size: settings::message_sizes) {
+            auto const payload = std::string(message_size, 'x');
+            auto saturated = false;
+            for(auto const threads: settings::thread_counts) {
+                auto const r = run_benchmark(queue_size, payload, threads);
+                auto const mark = r.blocks != 0 && !saturated ? " <" : "";
+                saturated = saturated || r.blocks != 0;
+                std::printf("%10u %8zu %7u %12.0f %10.1f %10llu%s\n",
+                            queue_size,
+                            message_size,
+                            threads,
+                            r.messages_per_second,
+                            r.bytes_per_second / (1024. * 1024.),
+                            (unsigned long long)r.blocks,
+                            mark);
+                json.add(std::to_string(queue_size) + '/'
+                             + std::to_string(message_size) + '/'
+                             + std::to_string(threads),
+                         r.messages_per_second,
+                         "messages/s",
+                         report::better::higher);
+            }
+        }
+    std::printf("'<' marks the first thread count blocking on a full queue\n");
+
+    auto const json_path = report::json_path(argc, argv);
+    if(json_path && !json.write(json_path)) {
+        std::printf("Unable to write %s\n", json_path);
+        return 1;
+    }
+    return 0;
+}
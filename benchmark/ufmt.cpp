@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "report.hpp"
+#include "ubench.hpp"
+
+#include <ufmt/text.hpp>
+
+
+// Time of every basic_text operator for each storage, printed as CSV:
+//   storage,operation,nanoseconds,status
+// Status is 'ok' unless ubench considers the result unreliable. Times are
+// written as JSON with '--json path'.
+
+
+struct values {
+    std::int32_t int32 {-127562};
+    std::int64_t int64 {-1234567890123};
+    std::uint64_t uint64 {18446744073709ull};
+    double number {3.14159265358979};
+    char character {'K'};
+    std::string_view string {"benchmark"};
+    std::string owned {"benchmark"};
+    std::vector<int> vector {1, 2, 3, 4, 5, 6, 7, 8};
+};
+
+
+values volatile_values() {
+    // Keeps the compiler from formatting constants at compile time
+    static values volatile_copy;
+    values* volatile p = &volatile_copy;
+    return *p;
+}
+
+
+report json {"ufmt"};
+
+
+template<class S, typename F>
+void measure(char const* storage, char const* operation, F&& f) {
+    ufmt::basic_text<S> text;
+    text.reserve(256);
+    auto const r = ubench::run([&] {
+        text.clear();
+        f(text);
+        ubench::dont_optimize(text);
+    });
+    std::printf("%s,%s,%.2f,%s\n",
+                storage,
+                operation,
+                r.time.count(),
+                ubench::describe(r.code));
+    json.add(std::string {storage} + '/' + operation,
+             r.time.count(),
+             "ns",
+             report::better::lower);
+}
+
+
+template<class S>
+void measure_all(char const* storage) {
+    auto const v = volatile_values();
+    auto const span = std::span<int const> {v.vector};
+    using text = ufmt::basic_text<S>;
+
+    measure<S>(storage, "char", [&](text& t) { t << v.character; });
+    measure<S>(storage, "string_view", [&](text& t) { t << v.string; });
+    measure<S>(storage, "string", [&](text& t) { t << v.owned; });
+    measure<S>(storage, "literal", [&](text& t) { t << "benchmark"; });
+    measure<S>(storage, "int32", [&](text& t) { t << v.int32; });
+    measure<S>(storage, "int64", [&](text& t) { t << v.int64; });
+    measure<S>(storage, "uint64", [&](text& t) { t << v.uint64; });
+    measure<S>(storage, "double", [&](text& t) { t << v.number; });
+    measure<S>(storage, "precised", [&](text& t) {
+        t << ufmt::precised(v.number, 4);
+    });
+    measure<S>(storage, "fixed", [&](text& t) {
+        t << ufmt::fixed(v.int32, 12);
+    });
+    measure<S>(storage, "left", [&](text& t) {
+        t << ufmt::left(v.int32, 12);
+    });
+    measure<S>(storage, "right", [&](text& t) {
+        t << ufmt::right(v.int32, 12);
+    });
+    measure<S>(storage, "textize_int", [&](text& t) {
+        t << ufmt::textize(v.int32);
+    });
+    measure<S>(storage, "textize_string", [&](text& t) {
+        t << ufmt::textize(v.string);
+    });
+    measure<S>(storage, "vector", [&](text& t) { t << v.vector; });
+    measure<S>(storage, "span", [&](text& t) { t << span; });
+    measure<S>(storage, "record", [&](text& t) {
+        t << "Logging " << v.string << ' ' << v.int32 << ' ' << v.number;
+    });
+}
+
+
+int main(int argc, char** argv) {
+    std::printf("storage,operation,nanoseconds,status\n");
+    measure_all<std::string>("text");
+    measure_all<ufmt::short_string>("short_text");
+    measure_all<ufmt::string>("fixed_text");
+
+    auto const json_path = report::json_path(argc, argv);
+    if(json_path && !json.write(json_path)) {
+        std::printf("Unable to write %s\n", json_path);
+        return 1;
+    }
+    return 0;
+}
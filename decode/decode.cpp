@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <chronicle/binary_reader.hpp>
+#include <chronicle/fields/default_format.hpp>
+#include <chronicle/mapped_file.hpp>
+
+#include <ufmt/print.hpp>
+
+
+// Renders chronicle binary logs as text:
+//   chronicle-decode [-o output] [-s] file...
+// Files are decoded in the given order, each rotated part of a session
+// carries its own callsite definitions and can be decoded alone. '-s'
+// omits thread ids as the single-threaded format does.
+
+
+template<class F>
+std::error_code decode(chronicle::binary_reader& reader,
+                       std::string_view data,
+                       FILE* output) {
+    constexpr std::size_t output_chunk = 1 << 20;
+    ufmt::text buffer;
+    buffer.reserve(output_chunk + (1 << 16));
+    chronicle::binary_record record;
+    std::error_code ec;
+    reader.feed(data);
+    while(reader.next(record, ec)) {
+        chronicle::binary_reader::render<F>(record, buffer);
+        if(buffer.size() >= output_chunk) {
+            std::fwrite(buffer.data(), 1, buffer.size(), output);
+            buffer.clear();
+        }
+    }
+    std::fwrite(buffer.data(), 1, buffer.size(), output);
+    return ec;
+}
+
+
+int main(int argc, char** argv) {
+    FILE* output = stdout;
+    bool single_threaded = false;
+    std::vector<std::string_view> paths;
+
+    for(int i = 1; i != argc; ++i) {
+        auto const option = std::string_view {argv[i]};
+        auto const has_value = i + 1 != argc;
+        if(option == "-o" && has_value) {
+            auto const path = std::string_view {argv[++i]};
+            output = std::fopen(path.data(), "wb");
+            if(!output)
+                return ufmt::error_with(-1, "error: unable to open ", path);
+        } else if(option == "-s")
+            single_threaded = true;
+        else if(!option.empty() && option[0] == '-')
+            return ufmt::error_with(-1, "error: unknown option ", option);
+        else
+            paths.push_back(option);
+    }
+    if(paths.empty())
+        return ufmt::error_with(-1,
+                                "usage: chronicle-decode [-o output] [-s] file...");
+
+    namespace fields = chronicle::fields;
+    chronicle::binary_reader reader;
+    for(auto const path: paths) {
+        auto const mapped = chronicle::mapped_file::open(path);
+        if(!mapped)
+            return ufmt::error_with(-1, "error: ", path, ": ",
+                                    mapped.error().message());
+        auto const ec = single_threaded
+            ? decode<fields::format_singlethreaded_default>(reader,
+                                                            mapped->view(),
+                                                            output)
+            : decode<fields::format_multithreaded_default>(reader,
+                                                           mapped->view(),
+                                                           output);
+        if(ec)
+            return ufmt::error_with(-1, "error: ", path, ": ", ec.message());
+    }
+    if(output != stdout)
+        std::fclose(output);
+    return 0;
+}
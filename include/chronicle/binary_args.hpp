@@ -0,0 +1,207 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+namespace chronicle {
+
+
+    enum class binary_type : std::uint8_t {
+        boolean,
+        character,
+        signed_integer,     // zigzag varint
+        unsigned_integer,   // varint
+        single_float,       // 4 bytes
+        double_float,       // 8 bytes
+        string,             // varint size and bytes
+        literal             // defined with the callsite, no bytes
+    };   // binary_type
+
+
+    namespace binary {
+
+        // Written as the prologue of each log session
+        constexpr std::string_view session_header {"\x01"
+                                                   "CHRNBIN\x01",
+                                                   9};
+
+        // First varint of an entry is 'callsite id << 3 | severity',
+        // callsite ids start from one, zero is followed by a callsite
+        // definition, one by the rest of session header and two by the
+        // time (zigzag) records of a further part are relative to
+        constexpr std::uint64_t definition_key = 0;
+        constexpr std::uint64_t session_key = 1;
+        constexpr std::uint64_t part_key = 2;
+
+
+        constexpr std::size_t max_varint_size = 10;
+
+
+        // Returns number of bytes written to 'out'
+        inline std::size_t put_varint(char* out, std::uint64_t value) noexcept {
+            std::size_t n = 0;
+            while(value >= 0x80) {
+                out[n++] = char(std::uint8_t(value) | 0x80);
+                value >>= 7;
+            }
+            out[n++] = char(value);
+            return n;
+        }
+
+
+        inline bool get_varint(std::string_view& in,
+                               std::uint64_t& value) noexcept {
+            value = 0;
+            for(unsigned shift = 0; shift < 64; shift += 7) {
+                if(in.empty())
+                    return false;
+                auto const byte = std::uint8_t(in.front());
+                in.remove_prefix(1);
+                value |= std::uint64_t(byte & 0x7F) << shift;
+                if((byte & 0x80) == 0)
+                    return true;
+            }
+            return false;
+        }
+
+
+        constexpr std::uint64_t zigzag(std::int64_t value) noexcept {
+            return (std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63);
+        }
+
+
+        constexpr std::int64_t unzigzag(std::uint64_t value) noexcept {
+            return std::int64_t(value >> 1) ^ -std::int64_t(value & 1);
+        }
+
+
+        // String literal argument written once per callsite, e.g.
+        //   log.info("order", "filled", binary::literal {" px="}, px);
+        // Constructor is consteval, so only constants of static storage
+        // duration are accepted
+        struct literal {
+            std::string_view text;
+
+            template<std::size_t N>
+            consteval literal(char const (&s)[N]) noexcept: text {s, N - 1} {}
+        };   // literal
+
+    }   // namespace binary
+
+
+    // Arguments of a binary log record: their types and raw bytes.
+    // Formatting is left to the decoder. Char arrays are copied up to the
+    // first zero, binary::literal is written once per callsite, as tag
+    // and text.
+    class binary_args {
+    public:
+        static constexpr std::size_t max_args = 16;
+
+    private:
+        std::array<binary_type, max_args> types_ {};
+        std::size_t count_ {0};
+        std::array<std::string_view, max_args> literals_ {};
+        std::size_t literals_count_ {0};
+        std::string bytes_;
+
+    public:
+        void clear() noexcept {
+            count_ = 0;
+            literals_count_ = 0;
+            bytes_.clear();
+        }
+
+
+        std::string_view types() const noexcept {
+            return {reinterpret_cast<char const*>(types_.data()), count_};
+        }
+
+
+        std::string_view bytes() const noexcept { return bytes_; }
+
+
+        std::string_view const* literals() const noexcept {
+            return literals_.data();
+        }
+
+
+        std::size_t literals_count() const noexcept { return literals_count_; }
+
+
+        // Arguments beyond max_args are dropped
+        template<typename T>
+        friend binary_args& operator<<(binary_args& args, T&& value) {
+            using U = std::remove_cvref_t<T>;
+            if(args.count_ == max_args)
+                return args;
+            if constexpr(std::is_same_v<U, binary::literal>) {
+                args.types_[args.count_++] = binary_type::literal;
+                args.literals_[args.literals_count_++] = value.text;
+            } else if constexpr(std::is_array_v<U>
+                                && std::is_same_v<std::remove_cv_t<
+                                                      std::remove_extent_t<U>>,
+                                                  char>) {
+                auto const* end = static_cast<char const*>(
+                    std::memchr(value, '\0', std::extent_v<U>));
+                auto const size = end ? std::size_t(end - value)
+                                      : std::extent_v<U>;
+                args.types_[args.count_++] = binary_type::string;
+                args.put_varint(size);
+                args.bytes_.append(value, size);
+            } else if constexpr(std::is_same_v<U, bool>) {
+                args.types_[args.count_++] = binary_type::boolean;
+                args.bytes_.push_back(char(value));
+            } else if constexpr(std::is_same_v<U, char>) {
+                args.types_[args.count_++] = binary_type::character;
+                args.bytes_.push_back(value);
+            } else if constexpr(std::is_integral_v<U> && std::is_signed_v<U>) {
+                args.types_[args.count_++] = binary_type::signed_integer;
+                args.put_varint(binary::zigzag(std::int64_t(value)));
+            } else if constexpr(std::is_integral_v<U>) {
+                args.types_[args.count_++] = binary_type::unsigned_integer;
+                args.put_varint(std::uint64_t(value));
+            } else if constexpr(std::is_same_v<U, float>) {
+                args.types_[args.count_++] = binary_type::single_float;
+                args.put_raw(value);
+            } else if constexpr(std::is_floating_point_v<U>) {
+                args.types_[args.count_++] = binary_type::double_float;
+                args.put_raw(double(value));
+            } else {
+                static_assert(std::is_convertible_v<T, std::string_view>,
+                              "Type is not supported by binary log");
+                auto const sv = std::string_view {value};
+                args.types_[args.count_++] = binary_type::string;
+                args.put_varint(sv.size());
+                args.bytes_.append(sv);
+            }
+            return args;
+        }
+
+    private:
+        void put_varint(std::uint64_t value) {
+            char raw[binary::max_varint_size];
+            bytes_.append(raw, binary::put_varint(raw, value));
+        }
+
+
+        template<typename T>
+        void put_raw(T value) {
+            char raw[sizeof(T)];
+            std::memcpy(raw, &value, sizeof(T));
+            bytes_.append(raw, sizeof(T));
+        }
+
+    };   // binary_args
+
+
+}   // namespace chronicle
@@ -0,0 +1,50 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <chrono>
+#include <string>
+
+#include <chronicle/binary_args.hpp>
+#include <chronicle/fields/binary_format.hpp>
+#include <chronicle/text_log.hpp>
+#include <chronicle/traits.hpp>
+
+
+namespace chronicle {
+
+
+    // Text log writing chronicle::fields::binary_format, arguments are
+    // encoded by producers and rendered by chronicle::binary_reader.
+    // Each session starts with binary::session_header instead of prologue.
+    template<typename Tr>
+    struct binary_log: text_log<Tr> {
+        using base = text_log<Tr>;
+        using size_type = typename base::size_type;
+
+        static constexpr size_type default_message_size = 128;
+
+
+        binary_log(size_type message_size = default_message_size)
+            : base(message_size) {
+            this->prologue(std::string {binary::session_header});
+            this->epilogue({});
+        }
+
+
+        binary_log(binary_log const&) = delete;
+        binary_log& operator=(binary_log const&) = delete;
+
+    };   // binary_log
+
+
+    using unique_binary_log = binary_log<
+        traits_unique<binary_args, fields::binary_format, std::chrono::system_clock>>;
+    using shared_binary_log = binary_log<
+        traits_shared<binary_args, fields::binary_format, std::chrono::system_clock>>;
+
+
+}   // namespace chronicle
@@ -0,0 +1,266 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <ufmt/text.hpp>
+
+#include <chronicle/binary_args.hpp>
+#include <chronicle/callsites.hpp>
+#include <chronicle/fields/default_format.hpp>
+#include <chronicle/message.hpp>
+#include <chronicle/severity.hpp>
+#include <chronicle/traits.hpp>
+
+
+namespace chronicle {
+
+
+    struct binary_record {
+        enum severity severity { severity::info };
+        std::chrono::system_clock::time_point time;
+        unsigned thread_id {0};
+        std::uint32_t callsite_id {callsites::none};   // of the decoding process
+        std::string_view source;
+        std::string_view text;
+        std::string_view types;
+        std::string const* literals {nullptr};   // of literal arguments
+        std::string_view bytes;   // encoded arguments
+    };   // binary_record
+
+
+    // Decodes output of chronicle::binary_log. Each rotated file of
+    // a session starts with its own callsite definitions and can be
+    // decoded alone.
+    class binary_reader {
+        struct callsite {
+            std::string source;
+            std::string text;
+            std::string types;
+            std::vector<std::string> literals;
+            std::uint32_t callsite_id {callsites::none};
+            bool defined {false};
+        };   // callsite
+
+        std::vector<callsite> callsites_;   // indexed by id
+        std::int64_t time_ {0};
+        std::string_view input_;
+
+    public:
+        // Data should stay alive while records are read from it
+        void feed(std::string_view data) noexcept { input_ = data; }
+        bool empty() const noexcept { return input_.empty(); }
+
+
+        // Record stays valid until the next call, returns false at the
+        // end of data or with 'ec' set if data is malformed
+        bool next(binary_record& record, std::error_code& ec) {
+            ec.clear();
+            while(!input_.empty()) {
+                auto in = input_;
+                std::uint64_t key;
+                if(!binary::get_varint(in, key))
+                    return fail(ec);
+                if(key == binary::session_key) {
+                    auto const rest = binary::session_header.substr(1);
+                    if(in.substr(0, rest.size()) != rest)
+                        return fail(ec);
+                    in.remove_prefix(rest.size());
+                    callsites_.clear();
+                    time_ = 0;
+                } else if(key == binary::part_key) {
+                    std::uint64_t time;
+                    if(!binary::get_varint(in, time))
+                        return fail(ec);
+                    callsites_.clear();
+                    time_ = binary::unzigzag(time);
+                } else if(key == binary::definition_key) {
+                    if(!define(in))
+                        return fail(ec);
+                } else {
+                    auto const id = key >> 3;
+                    std::uint64_t thread_id, delta;
+                    if(id >= callsites_.size() || !callsites_[id].defined
+                       || !binary::get_varint(in, thread_id)
+                       || !binary::get_varint(in, delta))
+                        return fail(ec);
+                    auto const& site = callsites_[id];
+                    auto const size = args_size(site.types, in);
+                    if(size == std::string_view::npos)
+                        return fail(ec);
+                    time_ += binary::unzigzag(delta);
+                    record.severity = severity(key & 7);
+                    record.time = std::chrono::system_clock::time_point {
+                        std::chrono::duration_cast<
+                            std::chrono::system_clock::duration>(
+                            std::chrono::microseconds {time_})};
+                    record.thread_id = unsigned(thread_id);
+                    record.callsite_id = site.callsite_id;
+                    record.source = site.source;
+                    record.text = site.text;
+                    record.types = site.types;
+                    record.literals = site.literals.data();
+                    record.bytes = in.substr(0, size);
+                    input_ = in.substr(size);
+                    return true;
+                }
+                input_ = in;
+            }
+            return false;
+        }
+
+
+        // Renders record as it would be printed by text_log with format 'F'
+        template<class F = fields::format_multithreaded_default>
+        static void render(binary_record const& record, ufmt::text& output) {
+            message<ufmt::text, std::chrono::system_clock::time_point> m;
+            m.severity = record.severity;
+            m.time = record.time;
+            m.thread_id = record.thread_id;
+            m.callsite_id = record.callsite_id;
+            m.has_data = !record.types.empty();
+            auto bytes = record.bytes;
+            auto const* literal = record.literals;
+            for(auto const type: record.types)
+                if(binary_type(type) == binary_type::literal)
+                    m.data << *literal++;
+                else
+                    print_arg(binary_type(type), bytes, m.data);
+            F {}.template print<default_data_formatter<ufmt::text>>(m, output);
+        }
+
+    private:
+        static bool fail(std::error_code& ec) noexcept {
+            ec = std::make_error_code(std::errc::illegal_byte_sequence);
+            return false;
+        }
+
+
+        bool define(std::string_view& in) {
+            std::uint64_t id;
+            if(!binary::get_varint(in, id) || id == 0)
+                return false;
+            callsite site;
+            for(auto* field: {&site.source, &site.text, &site.types})
+                if(!get_string(in, *field))
+                    return false;
+            site.literals.resize(std::size_t(
+                std::count(site.types.begin(),
+                           site.types.end(),
+                           char(binary_type::literal))));
+            for(auto& literal: site.literals)
+                if(!get_string(in, literal))
+                    return false;
+            site.callsite_id = callsites::intern(site.source, site.text);
+            site.defined = true;
+            if(callsites_.size() <= id)
+                callsites_.resize(std::size_t(id) + 1);
+            callsites_[id] = std::move(site);
+            return true;
+        }
+
+
+        static bool get_string(std::string_view& in, std::string& out) {
+            std::uint64_t size;
+            if(!binary::get_varint(in, size) || size > in.size())
+                return false;
+            out.assign(in.data(), std::size_t(size));
+            in.remove_prefix(std::size_t(size));
+            return true;
+        }
+
+
+        // Returns npos if arguments are truncated
+        static std::size_t args_size(std::string_view types,
+                                     std::string_view in) noexcept {
+            auto const begin = in.size();
+            std::uint64_t value;
+            for(auto const type: types) {
+                std::size_t fixed = 0;
+                switch(binary_type(type)) {
+                case binary_type::boolean:
+                case binary_type::character: fixed = 1; break;
+                case binary_type::single_float: fixed = 4; break;
+                case binary_type::double_float: fixed = 8; break;
+                case binary_type::literal: break;
+                case binary_type::signed_integer:
+                case binary_type::unsigned_integer:
+                    if(!binary::get_varint(in, value))
+                        return std::string_view::npos;
+                    break;
+                case binary_type::string:
+                    if(!binary::get_varint(in, value))
+                        return std::string_view::npos;
+                    fixed = std::size_t(value);
+                    break;
+                default: return std::string_view::npos;
+                }
+                if(fixed > in.size())
+                    return std::string_view::npos;
+                in.remove_prefix(fixed);
+            }
+            return begin - in.size();
+        }
+
+
+        // Arguments are checked by args_size already
+        static void print_arg(binary_type type,
+                              std::string_view& in,
+                              ufmt::text& output) {
+            std::uint64_t value = 0;
+            switch(type) {
+            case binary_type::boolean:
+                output << int(in.front() != 0);
+                in.remove_prefix(1);
+                return;
+            case binary_type::character:
+                output << in.front();
+                in.remove_prefix(1);
+                return;
+            case binary_type::signed_integer:
+                binary::get_varint(in, value);
+                output << binary::unzigzag(value);
+                return;
+            case binary_type::unsigned_integer:
+                binary::get_varint(in, value);
+                output << value;
+                return;
+            case binary_type::single_float:
+                output << get_raw<float>(in);
+                return;
+            case binary_type::double_float:
+                output << get_raw<double>(in);
+                return;
+            case binary_type::string:
+                binary::get_varint(in, value);
+                output << in.substr(0, std::size_t(value));
+                in.remove_prefix(std::size_t(value));
+                return;
+            case binary_type::literal: return;
+            }
+        }
+
+
+        template<typename T>
+        static T get_raw(std::string_view& in) noexcept {
+            T value;
+            std::memcpy(&value, in.data(), sizeof(T));
+            in.remove_prefix(sizeof(T));
+            return value;
+        }
+
+    };   // binary_reader
+
+
+}   // namespace chronicle
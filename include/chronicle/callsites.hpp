@@ -0,0 +1,243 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+namespace chronicle {
+
+
+    struct callsite {
+        std::string source;
+        std::string text;
+        std::string prefix;   // "[source] text"
+        std::string file;
+        std::uint32_t line {0};
+        std::string function;
+        std::string file_line;   // "file:line"
+    };   // callsite
+
+
+}   // namespace chronicle
+
+
+namespace chronicle::callsites {
+
+
+    // Id of a message without callsite, refers to empty source and text
+    constexpr std::uint32_t none = 0;
+
+
+    namespace detail {
+
+        constexpr std::size_t chunk_size = 1024;
+        constexpr std::size_t max_chunks = 4096;
+        constexpr std::size_t initial_literals = 1 << 13;
+
+
+        // Never destroyed, loggers may use callsites until exit
+        struct registry {
+            std::mutex mutex;
+            std::unordered_map<std::string, std::uint32_t> ids;
+            std::uint32_t count {1};
+        };   // registry
+
+
+        inline registry& instance() {
+            static auto* const r = new registry;
+            return *r;
+        }
+
+
+        inline std::atomic<callsite*> chunks[max_chunks];
+        inline callsite const empty;
+
+
+        // Key is written before id is published and never changes after,
+        // empty while id is 'none'
+        struct literal {
+            char const* source;
+            char const* text;
+            char const* file;
+            std::uint_least32_t line;
+            std::atomic<std::uint32_t> id;
+        };   // literal
+
+
+        // Open addressing, filled under registry mutex. Probes stay short
+        // while it is filled up to 3/4, then it is replaced by a copy twice
+        // as large. Replaced tables are never freed, readers may still
+        // probe them.
+        struct literal_table {
+            std::size_t size;
+            std::size_t count;
+            literal* slots;
+        };   // literal_table
+
+
+        inline std::atomic<literal_table*> literals {nullptr};
+
+
+        inline std::size_t literal_hash(char const* text,
+                                        std::uint_least32_t line) noexcept {
+            auto const h = (reinterpret_cast<std::uintptr_t>(text) >> 2)
+                         + line * 31;
+            return std::size_t(h ^ (h >> 13));
+        }
+
+
+        inline void place(literal_table& table,
+                          std::size_t hash,
+                          literal const& key,
+                          std::uint32_t id) noexcept {
+            for(auto i = hash;; ++i) {
+                auto& l = table.slots[i % table.size];
+                if(l.id.load(std::memory_order_relaxed) == none) {
+                    l.source = key.source;
+                    l.text = key.text;
+                    l.file = key.file;
+                    l.line = key.line;
+                    l.id.store(id, std::memory_order_release);
+                    ++table.count;
+                    return;
+                }
+                if(l.source == key.source && l.text == key.text
+                   && l.file == key.file && l.line == key.line)
+                    return;
+            }
+        }
+
+
+        inline literal_table* grow(literal_table const* table) {
+            auto const size = table ? table->size * 2 : initial_literals;
+            auto* next = new literal_table {size, 0, new literal[size]()};
+            if(table)
+                for(std::size_t i = 0; i != table->size; ++i) {
+                    auto const& l = table->slots[i];
+                    auto const id = l.id.load(std::memory_order_relaxed);
+                    if(id != none)
+                        place(*next, literal_hash(l.text, l.line), l, id);
+                }
+            return next;
+        }
+
+    }   // namespace detail
+
+
+    // Callsites are never removed, so references and ids stay valid.
+    // Lock-free, safe to call from a signal handler.
+    inline callsite const& get(std::uint32_t id) noexcept {
+        auto const* const chunk =
+            detail::chunks[id / detail::chunk_size].load(
+                std::memory_order_acquire);
+        if(id == none || chunk == nullptr)
+            return detail::empty;
+        return chunk[id % detail::chunk_size];
+    }
+
+
+    // Same source, text and location give the same id, 'none' when the
+    // registry is full
+    inline std::uint32_t intern(std::string_view source,
+                                std::string_view text,
+                                std::source_location const& location = {}) {
+        using namespace detail;
+        auto& r = instance();
+        auto const file = std::string_view {location.file_name()};
+        auto const function = std::string_view {location.function_name()};
+        auto const line = std::to_string(location.line());
+        auto key = std::string {source};
+        for(auto const part: {text, file, std::string_view {line}, function}) {
+            key += '\0';
+            key += part;
+        }
+        std::lock_guard lock {r.mutex};
+        if(auto const it = r.ids.find(key); it != r.ids.end())
+            return it->second;
+        auto const id = r.count;
+        auto const n = id / chunk_size;
+        if(n == max_chunks)
+            return none;
+        auto* chunk = chunks[n].load(std::memory_order_relaxed);
+        if(chunk == nullptr) {
+            chunk = new callsite[chunk_size];
+            chunks[n].store(chunk, std::memory_order_release);
+        }
+        auto& site = chunk[id % chunk_size];
+        site.source = source;
+        site.text = text;
+        site.prefix.reserve(source.size() + text.size() + 3);
+        site.prefix += '[';
+        site.prefix += source;
+        site.prefix += "] ";
+        site.prefix += text;
+        site.file = file;
+        site.line = location.line();
+        site.function = function;
+        if(!file.empty()) {
+            site.file_line = file;
+            site.file_line += ':';
+            site.file_line += line;
+        }
+        r.ids.emplace(std::move(key), id);
+        ++r.count;
+        return id;
+    }
+
+
+    // For string literals, identified by their addresses. Callsites seen
+    // before are found without locking or allocating, only the first call
+    // from a callsite interns it.
+    inline std::uint32_t
+        intern_literal(std::string_view source,
+                       std::string_view text,
+                       std::source_location const& location = {}) {
+        using namespace detail;
+        auto const h = literal_hash(text.data(), location.line());
+        auto const matches = [&](literal const& l) {
+            return l.source == source.data() && l.text == text.data()
+                && l.file == location.file_name()
+                && l.line == location.line();
+        };
+        if(auto const* table = literals.load(std::memory_order_acquire))
+            for(auto i = h;; ++i) {
+                auto const& l = table->slots[i % table->size];
+                auto const id = l.id.load(std::memory_order_acquire);
+                if(id == none)
+                    break;
+                if(matches(l))
+                    return id;
+            }
+
+        auto const id = intern(source, text, location);
+        if(id == none)
+            return id;
+        auto& r = instance();
+        std::lock_guard lock {r.mutex};
+        auto* table = literals.load(std::memory_order_relaxed);
+        if(!table || table->count == table->size / 4 * 3) {
+            table = grow(table);
+            literals.store(table, std::memory_order_release);
+        }
+        literal const key {source.data(),
+                           text.data(),
+                           location.file_name(),
+                           location.line(),
+                           {id}};
+        place(*table, h, key, id);
+        return id;
+    }
+
+
+}   // namespace chronicle::callsites
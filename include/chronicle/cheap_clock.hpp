@@ -0,0 +1,89 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+
+namespace chronicle {
+
+
+    // Time stamp counter where available, steady_clock otherwise. The
+    // counter is expected to be invariant and synchronized between cores,
+    // as on any recent x86 and arm64. An instance converts ticks to
+    // nanoseconds and calibrates itself against steady_clock on update(),
+    // so it should be used by a single thread.
+    class cheap_clock {
+        using steady_clock = std::chrono::steady_clock;
+
+        // Shorter periods give too coarse a ratio
+        static constexpr auto calibration_period = std::chrono::milliseconds {1};
+
+        std::uint64_t origin_ticks_ {0};
+        steady_clock::time_point origin_;
+        double ns_per_tick_ {0.};
+
+    public:
+        static std::uint64_t ticks() noexcept {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#elif defined(__aarch64__)
+            std::uint64_t value;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+            return value;
+#else
+            return std::uint64_t(
+                steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+
+        bool calibrated() const noexcept { return ns_per_tick_ != 0.; }
+
+
+        void reset() noexcept {
+            origin_ticks_ = ticks();
+            origin_ = steady_clock::now();
+            ns_per_tick_ = 0.;
+        }
+
+
+        // Ratio is taken over the whole time since reset
+        void update() noexcept {
+            auto const now_ticks = ticks();
+            auto const elapsed = steady_clock::now() - origin_;
+            if(elapsed < calibration_period || now_ticks <= origin_ticks_)
+                return;
+            ns_per_tick_ =
+                std::chrono::duration<double, std::nano>(elapsed).count()
+                / double(now_ticks - origin_ticks_);
+        }
+
+
+        // Sleeps for 'period', for callers needing the ratio right away
+        void calibrate(std::chrono::milliseconds period) {
+            reset();
+            std::this_thread::sleep_for(period);
+            update();
+        }
+
+
+        std::uint64_t nanoseconds(std::uint64_t ticks) const noexcept {
+            return std::uint64_t(double(ticks) * ns_per_tick_);
+        }
+
+    };   // cheap_clock
+
+
+}   // namespace chronicle
@@ -0,0 +1,63 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <atomic>
+
+#include <hydra/sequence.hpp>
+
+
+namespace chronicle {
+
+
+    // Completes when backend has written and synced the batch containing
+    // the record. Refers to the log, so it should not outlive it.
+    class completion {
+    public:
+        using value_type = hydra::sequence::value_type;
+        using counter_type = std::atomic<value_type>;
+
+    private:
+        counter_type const* committed_ {nullptr};
+        counter_type const* durable_ {nullptr};
+        value_type sequence_ {-1};
+
+    public:
+        completion() noexcept = default;
+
+        completion(counter_type const& committed,
+                   counter_type const& durable,
+                   hydra::sequence sequence) noexcept
+            : committed_ {&committed},
+              durable_ {&durable},
+              sequence_ {sequence.value()} {}
+
+        // False if the record was not enqueued at all
+        explicit operator bool() const noexcept { return committed_ != nullptr; }
+
+
+        bool ready() const noexcept {
+            return !committed_
+                || committed_->load(std::memory_order_acquire) > sequence_;
+        }
+
+
+        // Returns true if the record is on disk
+        bool wait() const noexcept {
+            if(!committed_)
+                return false;
+            auto committed = committed_->load(std::memory_order_acquire);
+            while(committed <= sequence_) {
+                committed_->wait(committed, std::memory_order_acquire);
+                committed = committed_->load(std::memory_order_acquire);
+            }
+            return durable_->load(std::memory_order_acquire) > sequence_;
+        }
+
+    };   // completion
+
+
+}   // namespace chronicle
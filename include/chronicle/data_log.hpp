@@ -5,7 +5,13 @@
 #pragma once
 
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <initializer_list>
 #include <memory>
 #include <thread>
@@ -33,11 +39,14 @@
 
 #elif defined(__linux__)
 
+#    include <sched.h>
 #    include <unistd.h>
 
 #elif defined(__APPLE__)
 
 #include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 
 #else
 
@@ -52,9 +61,17 @@
 #include <hydra/spsc_queue.hpp>
 #include <ufmt/text.hpp>
 
+#include <chronicle/callsites.hpp>
+#include <chronicle/cheap_clock.hpp>
+#include <chronicle/completion.hpp>
+#include <chronicle/fatal_signals.hpp>
+#include <chronicle/flush_policy.hpp>
 #include <chronicle/message.hpp>
+#include <chronicle/probes.hpp>
 #include <chronicle/severity.hpp>
 #include <chronicle/sink.hpp>
+#include <chronicle/source_tag.hpp>
+#include <chronicle/stats.hpp>
 #include <chronicle/traits.hpp>
 
 
@@ -76,19 +93,57 @@ namespace chronicle {
         using batch_type = typename activity_type::batch_type;
         using size_type = typename activity_type::size_type;
         using sinks_type = std::vector<std::unique_ptr<sink>>;
+        using steady_clock = std::chrono::steady_clock;
+        using steady_time_point = steady_clock::time_point;
 
 
         static constexpr size_type default_queue_size = 8192;
+        static constexpr std::chrono::milliseconds crash_wait {50};
 
     private:
+        struct attachment {
+            sink_ptr sink;
+            enum severity severity;
+            ufmt::text buffer;
+        };   // attachment
+
         sink_ptr sink_ptr_;
         enum severity severity_ { chronicle::severity::info };
+        enum severity accepted_ { chronicle::severity::info };
+        enum severity threshold_ { chronicle::severity::info };
+        std::vector<attachment> attached_;
+        std::vector<message_type> backtrace_;
+        std::size_t backtrace_next_ {0};
+        std::size_t backtrace_size_ {0};
+        enum severity backtrace_severity_ { chronicle::severity::debug };
         activity_type activity_;
         size_type message_size_;
         ufmt::text buffer_;
+        ufmt::text line_;
         format_type format_;
         std::string prologue_ {"\n    ++++ log opened ++++\n"};
         std::string epilogue_ {"    ++++ log closed ++++\n\n"};
+        struct flush_policy flush_policy_;
+        std::size_t unflushed_ {0};
+        bool sync_requested_ {false};
+        completion::value_type pending_commit_ {0};
+        completion::counter_type committed_ {0};
+        completion::counter_type durable_ {0};
+        steady_time_point flush_deadline_ {steady_time_point::max()};
+        steady_time_point sync_deadline_ {steady_time_point::max()};
+        std::atomic_bool halted_ {false};
+        std::atomic_bool processing_ {false};
+        std::atomic_bool crash_guarded_ {false};
+        std::atomic<std::uint64_t> fetched_ {0};
+        ufmt::basic_text<ufmt::large_string> crash_buffer_;
+        backend_stats backend_stats_;
+        std::atomic<std::uint64_t> dropped_ {0};
+        cheap_clock cheap_clock_;
+        std::chrono::milliseconds report_interval_ {0};
+        steady_time_point report_deadline_ {steady_time_point::max()};
+        std::array<std::uint64_t, chronicle::stats::residence_buckets>
+            reported_ {};
+        message_type report_;
 
     public:
         data_log(size_type message_size) noexcept
@@ -99,7 +154,12 @@ namespace chronicle {
         ~data_log() { close(); }
         bool opened() const noexcept { return activity_.active(); }
         enum severity severity() const noexcept { return severity_; }
-        void severity(enum severity s) noexcept { severity_ = s; }
+
+
+        void severity(enum severity s) noexcept {
+            severity_ = s;
+            update_threshold();
+        }
 
 
         size_type blocks_count() const noexcept {
@@ -107,6 +167,19 @@ namespace chronicle {
         }
 
 
+        // Lock-free, can be called from any thread
+        struct stats stats() const noexcept {
+            struct stats s;
+            backend_stats_.read(s);
+            s.enqueued = std::uint64_t(activity_.claimed_count());
+            s.dropped = dropped_.load(std::memory_order_relaxed);
+            s.blocks = std::uint64_t(activity_.blocks_count());
+            s.occupancy = s.enqueued > s.processed ? s.enqueued - s.processed
+                                                   : 0;
+            return s;
+        }
+
+
         void prologue(std::string text) noexcept {
             prologue_ = std::move(text);
         }
@@ -121,6 +194,77 @@ namespace chronicle {
             if(!sink_ptr_)
                 return;
             sink_ptr_->flush();
+            for(auto& a: attached_)
+                a.sink->flush();
+        }
+
+
+        struct flush_policy const& flush_policy() const noexcept {
+            return flush_policy_;
+        }
+
+
+        // Should be set before opening, the policy is applied by backend
+        void flush_policy(struct flush_policy const& fp) noexcept {
+            flush_policy_ = fp;
+        }
+
+
+        // Every 'interval' backend logs an info line from "chronicle" with
+        // the number of messages drained since the previous one, median,
+        // p99 and max of their time in the queue. Should be set before
+        // opening, 0 disables.
+        void self_report(std::chrono::milliseconds interval) noexcept {
+            report_interval_ = interval;
+        }
+
+
+        // Messages more verbose than any sink accepts down to 's' are kept
+        // unformatted, the last 'count' of them are written before the next
+        // error or failure. Should be set before opening, 0 disables.
+        void backtrace(std::size_t count, enum severity s) {
+            backtrace_.clear();
+            backtrace_.shrink_to_fit();
+            backtrace_.resize(count);
+            backtrace_next_ = 0;
+            backtrace_size_ = 0;
+            backtrace_severity_ = s;
+            update_threshold();
+        }
+
+
+        // On SIGSEGV, SIGABRT, SIGBUS, SIGFPE or SIGILL producers are stopped,
+        // messages left in the queue are formatted one by one into a fixed
+        // buffer, longer ones truncated, and written with write(2) to every
+        // sink having a descriptor, followed by a crash marker. Then the
+        // signal is raised again. Sinks are flushed after every batch, threads
+        // logging to it get an alternate signal stack, so stack overflow is
+        // handled too. Stays in effect until close, not available on Windows.
+        bool drain_on_crash() {
+            if(crash_guarded_.load())
+                return true;
+            fatal_signals::guard_thread();
+            crash_guarded_.store(fatal_signals::attach(this, &drain_crashed));
+            return crash_guarded_.load();
+        }
+
+
+        // Additional sink with its own severity, should be attached before
+        // opening. Each message is formatted once and copied to every sink
+        // accepting it. Attached sinks are closed and detached by close().
+        etceteras::expected<void, std::error_code>
+            attach(expected_sink_ptr&& esp, enum severity s) {
+            if(!esp)
+                return etceteras::make_unexpected(esp.error());
+            if(!(*esp)->ready())
+                return etceteras::make_unexpected(
+                    std::make_error_code(std::errc::bad_file_descriptor));
+            if(activity_.active())
+                return etceteras::make_unexpected(
+                    std::make_error_code(std::errc::device_or_resource_busy));
+            attached_.push_back(attachment {std::move(*esp), s, {}});
+            update_threshold();
+            return {};
         }
 
 
@@ -133,28 +277,31 @@ namespace chronicle {
                 return etceteras::make_unexpected(
                     std::make_error_code(std::errc::bad_file_descriptor));
             sink_ptr_ = std::move(*esp);
+            format_ = format_type {};
 
-            if(!prologue_.empty())
+            if(!prologue_.empty()) {
                 sink_ptr_->prologue(prologue_.data(), prologue_.size());
+                for(auto& a: attached_)
+                    a.sink->prologue(prologue_.data(), prologue_.size());
+            }
 
             activity_.reserve(queue_size);
 
-            auto const started = activity_.run([this](auto& batch) {
-                buffer_.clear();
-                buffer_.reserve(message_size_ * batch.size());
-
-                auto const now = clock_type::now();
-
-                while(auto sequence = batch.try_fetch()) {
-                    message_type& message = batch[sequence];
-                    message.time = now;
-                    format_.template print<data_formatter_type>(message,
-                                                                buffer_);
-                    batch.fetched();
-                }
-
-                sink_ptr_->write(now, buffer_.data(), buffer_.size());
-            });
+            unflushed_ = 0;
+            sync_requested_ = false;
+            pending_commit_ = 0;
+            backtrace_size_ = 0;
+            flush_deadline_ = steady_time_point::max();
+            sync_deadline_ = steady_time_point::max();
+            report_deadline_ = steady_time_point::max();
+            reported_ = stats().residence;
+            report_.callsite_id =
+                callsites::intern("chronicle", "queue residence");
+            cheap_clock_.reset();
+
+            auto const started =
+                activity_.run([this](auto& batch) { process(batch); },
+                              [this]() { return maintain(); });
 
             if(!started)
                 return etceteras::make_unexpected(
@@ -165,69 +312,82 @@ namespace chronicle {
 
 
         void close() {
+            if(crash_guarded_.load()) {
+                fatal_signals::detach(this);
+                crash_guarded_.store(false);
+            }
             if(!activity_.active())
                 return;
             activity_.stop();
-            if(!epilogue_.empty())
+            if(sync_requested_)
+                commit();
+            if(!epilogue_.empty()) {
                 sink_ptr_->epilogue(epilogue_.data(), epilogue_.size());
+                for(auto& a: attached_)
+                    a.sink->epilogue(epilogue_.data(), epilogue_.size());
+            }
             sink_ptr_->close();
+            for(auto& a: attached_)
+                a.sink->close();
+            attached_.clear();
+            update_threshold();
         }
 
 
-        template<size_t N1, size_t N2>
-        void failure(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void failure(source_tag tag, char const (&text)[N2]) {
             this->template print<severity::failure>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1, size_t N2>
-        void failure(char const (&tag)[N1],
+        template<size_t N2>
+        void failure(source_tag tag,
                      char const (&text)[N2],
                      data_type const& data) {
             this->template print<severity::failure>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 data);
         }
 
 
-        template<size_t N1, size_t N2>
-        void error(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void error(source_tag tag, char const (&text)[N2]) {
             this->template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1, size_t N2>
-        void error(char const (&tag)[N1],
+        template<size_t N2>
+        void error(source_tag tag,
                    char const (&text)[N2],
                    data_type const& data) {
             this->template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 data);
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R error_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R error_with(R&& r, source_tag tag, char const (&text)[N2]) {
             this->template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
             return std::forward<R>(r);
         }
 
 
-        template<typename R, size_t N1, size_t N2>
+        template<typename R, size_t N2>
         R error_with(R&& r,
-                     char const (&tag)[N1],
+                     source_tag tag,
                      char const (&text)[N2],
                      data_type const& data) {
             this->template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 data);
             return std::forward<R>(r);
@@ -235,77 +395,97 @@ namespace chronicle {
 
 
 
-        template<size_t N1, size_t N2>
-        void warning(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void warning(source_tag tag, char const (&text)[N2]) {
             this->template print<severity::warning>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1, size_t N2>
-        void warning(char const (&tag)[N1],
+        template<size_t N2>
+        void warning(source_tag tag,
                      char const (&text)[N2],
                      data_type const& data) {
             this->template print<severity::warning>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 data);
         }
 
 
-        template<size_t N1, size_t N2>
-        void info(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void info(source_tag tag, char const (&text)[N2]) {
             this->template print<severity::info>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1, size_t N2>
-        void info(char const (&tag)[N1],
+        template<size_t N2>
+        void info(source_tag tag,
                   char const (&text)[N2],
                   data_type const& data) {
             this->template print<severity::info>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 data);
         }
 
 
-        template<size_t N1, size_t N2>
-        void extra(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        completion info_durable(source_tag tag,
+                                char const (&text)[N2]) {
+            return this->template print_durable<severity::info>(
+                tag,
+                std::string_view {text, N2 - 1});
+        }
+
+
+        template<size_t N2>
+        completion info_durable(source_tag tag,
+                                char const (&text)[N2],
+                                data_type const& data) {
+            return this->template print_durable<severity::info>(
+                tag,
+                std::string_view {text, N2 - 1},
+                data);
+        }
+
+
+        template<size_t N2>
+        void extra(source_tag tag, char const (&text)[N2]) {
             this->template print<severity::extra>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1, size_t N2>
-        void extra(char const (&tag)[N1],
+        template<size_t N2>
+        void extra(source_tag tag,
                    char const (&text)[N2],
                    data_type const& data) {
             this->template print<severity::extra>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 data);
         }
 
 
-        template<size_t N1, size_t N2>
-        void trace(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void trace(source_tag tag, char const (&text)[N2]) {
             this->template print<severity::trace>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1, size_t N2>
-        void trace(char const (&tag)[N1],
+        template<size_t N2>
+        void trace(source_tag tag,
                    char const (&text)[N2],
                    data_type const& data) {
             this->template print<severity::trace>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 data);
         }
@@ -314,31 +494,31 @@ namespace chronicle {
 #ifdef NDEBUG
 
 
-        template<size_t N1, size_t N2>
-        void debug(char const (&)[N1], char const (&)[N2]) {}
+        template<size_t N2>
+        void debug(source_tag, char const (&)[N2]) {}
 
 
-        template<size_t N1, size_t N2>
-        void debug(char const (&)[N1], char const (&)[N2], data_type const&) {}
+        template<size_t N2>
+        void debug(source_tag, char const (&)[N2], data_type const&) {}
 
 
 #else
 
 
-        template<size_t N1, size_t N2>
-        void debug(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void debug(source_tag tag, char const (&text)[N2]) {
             this->template print<severity::debug>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1, size_t N2>
-        void debug(char const (&tag)[N1],
+        template<size_t N2>
+        void debug(source_tag tag,
                    char const (&text)[N2],
                    data_type const& data) {
             this->template print<severity::debug>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 data);
         }
@@ -348,9 +528,462 @@ namespace chronicle {
 
 
     protected:
+        enum severity threshold() const noexcept { return threshold_; }
+
+
+        void update_threshold() noexcept {
+            accepted_ = severity_;
+            for(auto const& a: attached_)
+                accepted_ = (std::max)(accepted_, a.severity);
+            threshold_ = accepted_;
+            if(!backtrace_.empty())
+                threshold_ = (std::max)(threshold_, backtrace_severity_);
+        }
+
+
+        template<typename B>
+        void process(B& batch) {
+            processing_.store(true);
+            if(crash_guarded_.load(std::memory_order_relaxed))
+                fatal_signals::guard_thread();
+            if(halted_.load()) {
+                processing_.store(false);
+                std::this_thread::sleep_for(std::chrono::milliseconds {1});
+                return;
+            }
+
+            CHRONICLE_PROBE1(batch_start, batch.size());
+            backend_stats_.batch_started(
+                std::uint64_t(activity_.claimed_count()));
+            buffer_.clear();
+            buffer_.reserve(message_size_ * batch.size());
+            for(auto& a: attached_)
+                a.buffer.clear();
+            if constexpr(requires(format_type& f) { f.batch_started(); })
+                format_.batch_started();
+
+            auto const now = clock_type::now();
+            auto const format_started = steady_clock::now();
+            cheap_clock_.update();
+
+            while(auto sequence = batch.try_fetch()) {
+                CHRONICLE_PROBE1(fetch, sequence.value());
+                fetched_.store(sequence.value(), std::memory_order_relaxed);
+                message_type& message = batch[sequence];
+                message.time = now;
+                if(cheap_clock_.calibrated()) {
+                    // Counters of cores may differ by a few ticks
+                    auto const fetched = cheap_clock::ticks();
+                    auto const waited = fetched > message.claimed
+                        ? fetched - message.claimed
+                        : 0;
+                    backend_stats_.message_waited(
+                        cheap_clock_.nanoseconds(waited));
+                }
+                if(!backtrace_.empty()) {
+                    if(accepted_ < message.severity && !message.durable) {
+                        keep(message);
+                        batch.fetched();
+                        continue;
+                    }
+                    if(message.severity <= chronicle::severity::error)
+                        replay(message.severity);
+                }
+                if(attached_.empty())
+                    format_.template print<data_formatter_type>(message,
+                                                                buffer_);
+                else
+                    dispatch(message, message.severity);
+                if(message.durable) {
+                    sync_requested_ = true;
+                    pending_commit_ = sequence.value() + 1;
+                } else if(requires_sync(message.severity))
+                    sync_requested_ = true;
+                batch.fetched();
+            }
+
+            auto const write_started = steady_clock::now();
+            auto bytes = buffer_.size();
+            CHRONICLE_PROBE1(write_start, buffer_.size());
+            write_to(*sink_ptr_, now, buffer_);
+            CHRONICLE_PROBE1(write_end, buffer_.size());
+            for(auto& a: attached_)
+                if(!a.buffer.empty()) {
+                    CHRONICLE_PROBE1(write_start, a.buffer.size());
+                    write_to(*a.sink, now, a.buffer);
+                    CHRONICLE_PROBE1(write_end, a.buffer.size());
+                    bytes += a.buffer.size();
+                }
+            auto const write_finished = steady_clock::now();
+            backend_stats_.batch_processed(batch.fetched_count(),
+                                           bytes,
+                                           write_started - format_started,
+                                           write_finished - write_started);
+
+            if(flush_policy_.interval.count() != 0 || flush_policy_.bytes != 0)
+                unflushed_ += buffer_.size();
+
+            CHRONICLE_PROBE2(batch_end, batch.fetched_count(), bytes);
+
+            // Crash drain writes past stdio, nothing may stay buffered
+            if(crash_guarded_.load(std::memory_order_relaxed))
+                flush();
+
+            processing_.store(false, std::memory_order_release);
+        }
+
+
+        void keep(message_type& message) {
+            using std::swap;
+            swap(backtrace_[backtrace_next_], message);
+            backtrace_next_ = (backtrace_next_ + 1) % backtrace_.size();
+            if(backtrace_size_ != backtrace_.size())
+                ++backtrace_size_;
+        }
+
+
+        // Kept messages go to every sink accepting the error they lead to
+        void replay(enum severity s) {
+            auto const n = backtrace_.size();
+            auto const first = (backtrace_next_ + n - backtrace_size_) % n;
+            for(std::size_t i = 0; i != backtrace_size_; ++i) {
+                auto const& kept = backtrace_[(first + i) % n];
+                if(!attached_.empty())
+                    dispatch(kept, s);
+                else if(s <= severity_)
+                    format_.template print<data_formatter_type>(kept, buffer_);
+            }
+            backtrace_size_ = 0;
+        }
+
+
+        static void drain_crashed(void* log, int signal) noexcept {
+            static_cast<data_log*>(log)->drain(signal);
+        }
+
+
+        // Runs in a signal handler: no locks, no stdio, no allocations
+        void drain(int signal) noexcept {
+#if !defined(_WIN32)
+            halted_.store(true);
+            wait_backend();
+
+            if(!sink_ptr_ || !activity_.active())
+                return;
+            auto guarded = sink_ptr_->crash_descriptor() != -1;
+            for(auto& a: attached_)
+                guarded = guarded || a.sink->crash_descriptor() != -1;
+            if(!guarded)
+                return;
+
+            // Backend is stuck in the middle of a batch or crashed itself,
+            // it may still touch the queue, buffers and formatter state
+            if(processing_.load()) {
+                crash_buffer_.clear();
+                crash_buffer_ << "    ++++ log crashed, signal " << signal
+                              << ", backend is busy, queued messages are lost"
+                                 " ++++\n\n";
+                crash_write(chronicle::severity::failure);
+                crash_sync();
+                return;
+            }
+
+            if constexpr(requires(format_type& f) { f.freeze(); })
+                format_.freeze();
+
+            if(!backtrace_.empty()) {
+                auto const n = backtrace_.size();
+                auto const first = (backtrace_next_ + n - backtrace_size_) % n;
+                for(std::size_t i = 0; i != backtrace_size_; ++i)
+                    crash_print(backtrace_[(first + i) % n],
+                                chronicle::severity::failure);
+                backtrace_size_ = 0;
+            }
+
+            auto const now = clock_type::now();
+            auto batch = activity_.pending();
+            while(auto sequence = batch.try_fetch()) {
+                message_type& message = batch[sequence];
+                message.time = now;
+                crash_print(message, message.severity);
+                batch.fetched();
+            }
+
+            crash_buffer_.clear();
+            crash_buffer_ << "    ++++ log crashed, signal " << signal
+                          << " ++++\n\n";
+            crash_write(chronicle::severity::failure);
+            crash_sync();
+#else
+            (void)signal;
+#endif
+        }
+
+
+#if !defined(_WIN32)
+        // Gives up when the backend makes no progress for 'crash_wait',
+        // yields since it may share the core
+        void wait_backend() noexcept {
+            auto fetched = fetched_.load(std::memory_order_relaxed);
+            auto progressed = monotonic_now();
+            while(processing_.load()) {
+                auto const now = monotonic_now();
+                auto const next = fetched_.load(std::memory_order_relaxed);
+                if(next != fetched) {
+                    fetched = next;
+                    progressed = now;
+                } else if(now - progressed >= crash_wait)
+                    return;
+                ::sched_yield();
+            }
+        }
+
+
+        static std::chrono::nanoseconds monotonic_now() noexcept {
+            timespec now {};
+            ::clock_gettime(CLOCK_MONOTONIC, &now);
+            return std::chrono::seconds {now.tv_sec}
+                 + std::chrono::nanoseconds {now.tv_nsec};
+        }
+
+
+        void crash_print(message_type const& message,
+                         enum severity s) noexcept {
+            crash_buffer_.clear();
+            format_.template print<data_formatter_type>(message, crash_buffer_);
+            // Truncated, the last byte makes room for line end
+            auto const size = crash_buffer_.size();
+            if(size == crash_buffer_.capacity()
+               && crash_buffer_[size - 1] != '\n')
+                crash_buffer_[size - 1] = '\n';
+            crash_write(s);
+        }
+
+
+        // Failure goes to every sink
+        void crash_write(enum severity s) noexcept {
+            if(s <= severity_)
+                write_all(sink_ptr_->crash_descriptor(), crash_buffer_);
+            for(auto& a: attached_)
+                if(s <= a.severity)
+                    write_all(a.sink->crash_descriptor(), crash_buffer_);
+        }
+
+
+        void crash_sync() noexcept {
+            if(auto const fd = sink_ptr_->crash_descriptor(); fd != -1)
+                ::fsync(fd);
+            for(auto& a: attached_)
+                if(auto const fd = a.sink->crash_descriptor(); fd != -1)
+                    ::fsync(fd);
+        }
+
+
+        template<class S>
+        static void write_all(int fd,
+                              ufmt::basic_text<S> const& text) noexcept {
+            if(fd == -1)
+                return;
+            auto data = text.data();
+            auto size = text.size();
+            while(size != 0) {
+                auto const written = ::write(fd, data, size);
+                if(written < 0) {
+                    if(errno == EINTR)
+                        continue;
+                    return;
+                }
+                data += written;
+                size -= std::size_t(written);
+            }
+        }
+#endif
+
+
+        // A sink starting a new file gets the part header of the format
+        // first, if it has one
+        void write_to(sink& s,
+                      sink::time_point const& tp,
+                      ufmt::text const& data) {
+            if constexpr(requires(format_type& f, ufmt::text& t) {
+                             f.part_header(t);
+                         }) {
+                if(s.rotate(tp, data.size())) {
+                    line_.clear();
+                    format_.part_header(line_);
+                    s.write(tp, line_.data(), line_.size());
+                }
+            }
+            s.write(tp, data.data(), data.size());
+        }
+
+
+        // Formats once, sinks accepting 's' get a copy
+        void dispatch(message_type const& message, enum severity s) {
+            line_.clear();
+            format_.template print<data_formatter_type>(message, line_);
+            if(s <= severity_)
+                buffer_.append(line_.data(), line_.size());
+            for(auto& a: attached_)
+                if(s <= a.severity)
+                    a.buffer.append(line_.data(), line_.size());
+        }
+
+
+        bool requires_sync(enum severity s) const noexcept {
+            return flush_policy_.sync_severity
+                && s <= *flush_policy_.sync_severity;
+        }
+
+
+        void commit() noexcept {
+            auto synced = sink_ptr_->sync();
+            for(auto& a: attached_)
+                synced = a.sink->sync() && synced;
+            if(pending_commit_ != 0) {
+                auto const order = std::memory_order_release;
+                if(synced)
+                    durable_.store(pending_commit_, order);
+                committed_.store(pending_commit_, order);
+                committed_.notify_all();
+                pending_commit_ = 0;
+            }
+            sync_requested_ = false;
+            sync_deadline_ = steady_time_point::max();
+            unflushed_ = 0;
+            flush_deadline_ = steady_time_point::max();
+        }
+
+
+        // Runs on backend after every wake-up, all sync requests collected
+        // since the previous call are served by a single commit. Marked as
+        // processing since it formats and writes like process() does.
+        steady_time_point maintain() noexcept {
+            processing_.store(true);
+            if(halted_.load()) {
+                processing_.store(false);
+                return steady_time_point::max();
+            }
+            auto const deadline = maintain_sinks();
+            if(crash_guarded_.load(std::memory_order_relaxed))
+                flush();
+            processing_.store(false, std::memory_order_release);
+            return deadline;
+        }
+
+
+        steady_time_point maintain_sinks() noexcept {
+            auto const report_deadline = report_interval_.count() != 0
+                ? report_residence()
+                : steady_time_point::max();
+
+            if(!sync_requested_ && unflushed_ == 0)
+                return report_deadline;
+
+            auto const now = steady_clock::now();
+
+            if(sync_requested_) {
+                if(sync_deadline_ == steady_time_point::max())
+                    sync_deadline_ = now + flush_policy_.sync_window;
+                if(now >= sync_deadline_)
+                    commit();
+            }
+
+            if(unflushed_ != 0) {
+                if(flush_policy_.interval.count() != 0
+                   && flush_deadline_ == steady_time_point::max())
+                    flush_deadline_ = now + flush_policy_.interval;
+                auto const exceeded = flush_policy_.bytes != 0
+                    && unflushed_ >= flush_policy_.bytes;
+                if(exceeded || now >= flush_deadline_) {
+                    flush();
+                    unflushed_ = 0;
+                    flush_deadline_ = steady_time_point::max();
+                }
+            }
+
+            return (std::min)(
+                {sync_deadline_, flush_deadline_, report_deadline});
+        }
+
+
+        // Returns the moment of the next report
+        steady_time_point report_residence() noexcept {
+            auto const now = steady_clock::now();
+            if(report_deadline_ == steady_time_point::max())
+                report_deadline_ = now + report_interval_;
+            if(now < report_deadline_)
+                return report_deadline_;
+            report_deadline_ = now + report_interval_;
+
+            auto const residence = stats().residence;
+            auto interval = residence;
+            std::uint64_t drained = 0;
+            for(std::size_t i = 0; i != interval.size(); ++i) {
+                interval[i] -= reported_[i];
+                drained += interval[i];
+            }
+            reported_ = residence;
+            auto const max = backend_stats_.take_interval_max_residence();
+            if(drained == 0 || accepted_ < chronicle::severity::info)
+                return report_deadline_;
+
+            report_.severity = chronicle::severity::info;
+            report_.time = clock_type::now();
+            report_.thread_id = current_thread_id();
+            report_.has_data = false;
+            if constexpr(requires(data_type& d) {
+                             d.clear();
+                             d << std::uint64_t {};
+                             d << " }";
+                         }) {
+                auto const percentile = [&](double p) {
+                    return chronicle::stats::log2_percentile(interval, p);
+                };
+                report_.data.clear();
+                report_.data << " { messages: " << drained
+                             << ", p50_ns: " << percentile(50.)
+                             << ", p99_ns: " << percentile(99.)
+                             << ", max_ns: " << std::uint64_t(max.count())
+                             << " }";
+                report_.has_data = true;
+            }
+
+            buffer_.clear();
+            for(auto& a: attached_)
+                a.buffer.clear();
+            if constexpr(requires(format_type& f) { f.batch_started(); })
+                format_.batch_started();
+            if(attached_.empty())
+                format_.template print<data_formatter_type>(report_, buffer_);
+            else
+                dispatch(report_, report_.severity);
+            write_to(*sink_ptr_, report_.time, buffer_);
+            for(auto& a: attached_)
+                if(!a.buffer.empty())
+                    write_to(*a.sink, report_.time, a.buffer);
+            if(flush_policy_.interval.count() != 0 || flush_policy_.bytes != 0)
+                unflushed_ += buffer_.size();
+            return report_deadline_;
+        }
+
+
+        static unsigned current_thread_id() noexcept {
+#if defined(_WIN32)
+            return unsigned(GetCurrentThreadId());
+#elif defined(__linux__)
+            return unsigned(gettid());
+#elif defined(__APPLE__)
+            uint64_t tid64;
+            pthread_threadid_np(NULL, &tid64);
+            return unsigned(tid64);
+#endif
+        }
+
+
         template<chronicle::severity S>
-        void print(std::string_view const& tag, std::string_view const& text) {
-            if(severity_ < S)
+        void print(source_tag const& tag, std::string_view const& text) {
+            if(threshold_ < S)
                 return;
             message_type* m = claim<S>(tag, text);
             if(!m)
@@ -360,10 +993,10 @@ namespace chronicle {
 
 
         template<chronicle::severity S>
-        void print(std::string_view const& tag,
+        void print(source_tag const& tag,
                    std::string_view const& text,
                    data_type const& data) {
-            if(severity_ < S)
+            if(threshold_ < S)
                 return;
             message_type* m = claim<S>(tag, text);
             if(!m)
@@ -374,30 +1007,72 @@ namespace chronicle {
         }
 
 
-        void publish(message_type const& m) { activity_.publish(m.sequence); }
+        template<chronicle::severity S>
+        completion print_durable(source_tag const& tag,
+                                 std::string_view const& text) {
+            if(threshold_ < S)
+                return {};
+            message_type* m = claim<S>(tag, text);
+            if(!m)
+                return {};
+            return publish_durable(*m);
+        }
+
+
+        template<chronicle::severity S>
+        completion print_durable(source_tag const& tag,
+                                 std::string_view const& text,
+                                 data_type const& data) {
+            if(threshold_ < S)
+                return {};
+            message_type* m = claim<S>(tag, text);
+            if(!m)
+                return {};
+            m->data = data;
+            m->has_data = true;
+            return publish_durable(*m);
+        }
+
+
+        void publish(message_type const& m) {
+            CHRONICLE_PROBE1(publish, m.sequence.value());
+            activity_.publish(m.sequence);
+        }
+
+
+        completion publish_durable(message_type& m) {
+            auto const sequence = m.sequence;
+            m.durable = true;
+            CHRONICLE_PROBE1(publish, sequence.value());
+            activity_.publish(sequence);
+            return completion {committed_, durable_, sequence};
+        }
 
 
         template<chronicle::severity S>
-        message_type* claim(std::string_view const& source,
+        message_type* claim(source_tag const& tag,
                             std::string_view const& text) {
+            if(halted_.load(std::memory_order_relaxed)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            if(crash_guarded_.load(std::memory_order_relaxed))
+                fatal_signals::guard_thread();
+            auto const callsite_id = callsites::intern_literal(tag.name, text, tag.location);
             auto const sequence = activity_.claim();
-            if(!sequence)
+            if(!sequence) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
                 return nullptr;
+            }
+            CHRONICLE_PROBE2(claim, sequence.value(), unsigned(S));
             message_type& m = activity_[sequence];
             m.sequence = sequence;
             m.severity = S;
-#if defined(_WIN32)
-            m.thread_id = unsigned(GetCurrentThreadId());
-#elif defined(__linux__)
-            m.thread_id = unsigned(gettid());
-#elif defined(__APPLE__)
-            uint64_t tid64;
-            pthread_threadid_np(NULL, &tid64);            
-            m.thread_id = unsigned(tid64);
-#endif
-            m.source = source;
-            m.text = text;
+            m.thread_id = current_thread_id();
+            m.callsite_id = callsite_id;
+            m.claimed = cheap_clock::ticks();
             m.has_data = false;
+            m.durable = false;
             return &m;
         }
 
@@ -0,0 +1,155 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <memory>
+
+
+namespace chronicle::fatal_signals {
+
+
+    // Called from a signal handler, so should be async-signal-safe
+    using drain_function = void (*)(void* context, int signal) noexcept;
+
+
+#if defined(_WIN32)
+
+    inline bool attach(void*, drain_function) noexcept { return false; }
+    inline void detach(void*) noexcept {}
+    inline void guard_thread() noexcept {}
+
+#else
+
+    namespace detail {
+
+        constexpr std::size_t max_logs = 16;
+        constexpr int signals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL};
+        constexpr std::size_t signals_count = sizeof(signals) / sizeof(int);
+
+
+        struct slot {
+            std::atomic<void*> context {nullptr};
+            std::atomic<drain_function> drain {nullptr};
+        };   // slot
+
+
+        inline slot slots[max_logs];
+        inline struct sigaction previous[signals_count];
+        inline std::atomic_flag installed;
+        inline std::atomic_flag draining;
+
+
+        inline void on_signal(int signal) {
+            if(!draining.test_and_set()) {
+                for(auto& s: slots) {
+                    void* const context = s.context.load();
+                    drain_function const drain = s.drain.load();
+                    if(context && drain)
+                        drain(context, signal);
+                }
+            }
+
+            for(std::size_t i = 0; i != signals_count; ++i)
+                if(signals[i] == signal)
+                    ::sigaction(signal, &previous[i], nullptr);
+            std::raise(signal);
+        }
+
+
+        inline void install() noexcept {
+            if(installed.test_and_set())
+                return;
+            struct sigaction action {};
+            action.sa_handler = &on_signal;
+            action.sa_flags = SA_ONSTACK;
+            sigemptyset(&action.sa_mask);
+            for(std::size_t i = 0; i != signals_count; ++i)
+                ::sigaction(signals[i], &action, &previous[i]);
+        }
+
+
+        // Handler runs on it after a stack overflow. Left alone if the
+        // thread already has an alternate stack.
+        class alternate_stack {
+            static constexpr std::size_t min_size = 64 * 1024;
+
+            std::unique_ptr<char[]> memory_;
+
+        public:
+            alternate_stack() noexcept {
+                stack_t current {};
+                if(::sigaltstack(nullptr, &current) != 0
+                   || !(current.ss_flags & SS_DISABLE))
+                    return;
+                auto const size = (std::max)(min_size, std::size_t(SIGSTKSZ));
+                memory_.reset(new(std::nothrow) char[size]);
+                if(!memory_)
+                    return;
+                stack_t stack {};
+                stack.ss_sp = memory_.get();
+                stack.ss_size = size;
+                if(::sigaltstack(&stack, nullptr) != 0)
+                    memory_.reset();
+            }
+
+
+            alternate_stack(alternate_stack const&) = delete;
+            alternate_stack& operator=(alternate_stack const&) = delete;
+
+
+            ~alternate_stack() {
+                if(!memory_)
+                    return;
+                stack_t disabled {};
+                disabled.ss_flags = SS_DISABLE;
+                ::sigaltstack(&disabled, nullptr);
+            }
+
+        };   // alternate_stack
+
+    }   // namespace detail
+
+
+    // Gives the calling thread an alternate signal stack for its lifetime,
+    // so a log can be drained after stack overflow in that thread
+    inline void guard_thread() noexcept {
+        thread_local detail::alternate_stack stack;
+    }
+
+
+    // Installs handlers for SIGSEGV, SIGABRT, SIGBUS, SIGFPE and SIGILL
+    // once. On a fatal signal every attached log is drained, then the
+    // previous handler is restored and the signal is raised again.
+    inline bool attach(void* context, drain_function drain) noexcept {
+        detail::install();
+        for(auto& s: detail::slots) {
+            void* expected = nullptr;
+            if(!s.context.compare_exchange_strong(expected, context))
+                continue;
+            s.drain.store(drain);
+            return true;
+        }
+        return false;
+    }
+
+
+    inline void detach(void* context) noexcept {
+        for(auto& s: detail::slots) {
+            if(s.context.load() != context)
+                continue;
+            s.drain.store(nullptr);
+            s.context.store(nullptr);
+        }
+    }
+
+#endif
+
+
+}   // namespace chronicle::fatal_signals
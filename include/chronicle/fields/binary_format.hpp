@@ -0,0 +1,176 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <ufmt/text.hpp>
+
+#include <chronicle/binary_args.hpp>
+#include <chronicle/callsites.hpp>
+#include <chronicle/message.hpp>
+
+
+namespace chronicle::fields {
+
+
+    // Writes records as 'id << 3 | severity', thread id and time delta in
+    // microseconds (zigzag) as varints followed by raw argument bytes.
+    // Source, text, argument types and literals of a callsite are defined
+    // once per log session, before its first record, and again by the part
+    // header starting each further file.
+    class binary_format {
+        struct callsite_key {
+            std::uint32_t id;
+            std::array<char, binary_args::max_args> types;
+            std::size_t count;
+            std::array<char const*, binary_args::max_args> literals;
+
+            bool operator==(callsite_key const&) const noexcept = default;
+        };   // callsite_key
+
+
+        struct callsite_hash {
+            std::size_t operator()(callsite_key const& key) const noexcept {
+                auto h = std::size_t(key.id);
+                for(std::size_t i = 0; i != key.count; ++i)
+                    if(key.literals[i])
+                        h = h * 31 + std::hash<void const*> {}(key.literals[i]);
+                return h * 31
+                     + std::hash<std::string_view> {}(
+                           std::string_view {key.types.data(), key.count});
+            }
+        };   // callsite_hash
+
+
+        struct callsite {
+            std::uint64_t id;
+            std::vector<std::string> literals;
+        };   // callsite
+
+
+        std::unordered_map<callsite_key, callsite, callsite_hash> callsites_;
+        std::uint64_t next_id_ {1};
+        std::int64_t previous_time_ {0};
+        std::int64_t batch_time_ {0};
+        binary_args no_args_;
+        bool frozen_ {false};
+
+    public:
+        // Nothing is allocated from now on, a callsite seen for the first
+        // time is defined before each of its records
+        void freeze() noexcept { frozen_ = true; }
+
+
+        // Records formatted after it are relative to the time part header
+        // tells
+        void batch_started() noexcept { batch_time_ = previous_time_; }
+
+
+        // Lets a further file of the session be decoded alone
+        template<class S>
+        void part_header(ufmt::basic_text<S>& output) {
+            char raw[binary::max_varint_size];
+            output.append(raw, binary::put_varint(raw, binary::part_key));
+            output.append(raw,
+                          binary::put_varint(raw, binary::zigzag(batch_time_)));
+            for(auto const& [key, site]: callsites_)
+                define(site.id,
+                       key.id,
+                       std::string_view {key.types.data(), key.count},
+                       site.literals.data(),
+                       site.literals.size(),
+                       output);
+        }
+
+
+        template<class DF, class S, typename D, class TimePoint>
+        void print(message<D, TimePoint> const& m, ufmt::basic_text<S>& text) {
+            namespace chr = std::chrono;
+            auto const id =
+                intern(m.callsite_id, m.has_data ? m.data : no_args_, text);
+            auto const time =
+                chr::duration_cast<chr::microseconds>(m.time.time_since_epoch())
+                    .count();
+
+            char header[3 * binary::max_varint_size];
+            auto n = binary::put_varint(header, id << 3 | unsigned(m.severity));
+            n += binary::put_varint(header + n, m.thread_id);
+            n += binary::put_varint(header + n,
+                                    binary::zigzag(time - previous_time_));
+            previous_time_ = time;
+            text.append(header, n);
+            if(m.has_data)
+                text.append(m.data.bytes().data(), m.data.bytes().size());
+        }
+
+    private:
+        // Literal arguments are told apart by addresses, contents are
+        // compared as well in case the same array holds another text
+        template<class S>
+        std::uint64_t intern(std::uint32_t callsite_id,
+                             binary_args const& args,
+                             ufmt::basic_text<S>& output) {
+            auto const types = args.types();
+            auto const* literals = args.literals();
+            auto const literals_count = args.literals_count();
+            auto key = callsite_key {callsite_id, {}, types.size(), {}};
+            std::copy(types.begin(), types.end(), key.types.begin());
+            for(std::size_t i = 0; i != literals_count; ++i)
+                key.literals[i] = literals[i].data();
+
+            auto const it = callsites_.find(key);
+            if(it != callsites_.end()
+               && std::equal(literals,
+                             literals + literals_count,
+                             it->second.literals.begin(),
+                             it->second.literals.end()))
+                return it->second.id;
+
+            auto const id = next_id_++;
+            define(id, callsite_id, types, literals, literals_count, output);
+            if(!frozen_)
+                callsites_.insert_or_assign(
+                    key,
+                    callsite {id, {literals, literals + literals_count}});
+            return id;
+        }
+
+
+        template<class S, typename L>
+        static void define(std::uint64_t id,
+                           std::uint32_t callsite_id,
+                           std::string_view types,
+                           L const* literals,
+                           std::size_t literals_count,
+                           ufmt::basic_text<S>& output) {
+            auto const& site = callsites::get(callsite_id);
+            char raw[binary::max_varint_size];
+            auto const put = [&](std::string_view field) {
+                output.append(raw, binary::put_varint(raw, field.size()));
+                output.append(field.data(), field.size());
+            };
+            output.append(raw, binary::put_varint(raw, binary::definition_key));
+            output.append(raw, binary::put_varint(raw, id));
+            put(site.source);
+            put(site.text);
+            put(types);
+            for(std::size_t i = 0; i != literals_count; ++i)
+                put(literals[i]);
+        }
+
+    };   // binary_format
+
+
+}   // namespace chronicle::fields
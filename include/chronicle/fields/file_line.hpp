@@ -0,0 +1,27 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <ufmt/text.hpp>
+
+#include <chronicle/callsites.hpp>
+#include <chronicle/message.hpp>
+
+
+namespace chronicle::fields {
+
+
+    // "file:line" of the logging call
+    class file_line {
+    public:
+        template<class S, typename D, class TimePoint>
+        void print(message<D, TimePoint> const& m, ufmt::basic_text<S>& text) {
+            text << callsites::get(m.callsite_id).file_line;
+        }
+
+    };   // file_line
+
+}   // namespace chronicle::fields
@@ -6,9 +6,12 @@
 
 
 #include <tuple>
+#include <type_traits>
 
 #include <ufmt/text.hpp>
 
+#include <chronicle/callsites.hpp>
+#include <chronicle/fields/source.hpp>
 #include <chronicle/message.hpp>
 
 
@@ -23,9 +26,20 @@ namespace chronicle::fields {
 
         template<class DF, class S, typename D, class TimePoint>
         void print(message<D, TimePoint> const& m, ufmt::basic_text<S>& text) {
-            print_fields<S, D, TimePoint, 0>(m, text);
-            text << ' ';
-            text << m.text;
+            constexpr auto n = std::tuple_size_v<fields_type>;
+            // Source followed by text is copied preformatted from callsite
+            if constexpr(std::is_same_v<std::tuple_element_t<n - 1, fields_type>,
+                                        source>) {
+                if constexpr(n != 1) {
+                    print_fields<S, D, TimePoint, 0, n - 1>(m, text);
+                    text << ' ';
+                }
+                text << callsites::get(m.callsite_id).prefix;
+            } else {
+                print_fields<S, D, TimePoint, 0, n>(m, text);
+                text << ' ';
+                text << m.text();
+            }
 
             if(m.has_data)
                 DF::format(text, m.data);
@@ -37,14 +51,14 @@ namespace chronicle::fields {
     private:
         fields_type fields_;
 
-        template<class S, typename D, class TimePoint, size_t I>
+        template<class S, typename D, class TimePoint, size_t I, size_t N>
         void print_fields(message<D, TimePoint> const& message,
                           ufmt::basic_text<S>& text) {
             std::get<I>(fields_).print(message, text);
 
-            if constexpr(I + 1 != std::tuple_size_v<fields_type>) {
+            if constexpr(I + 1 != N) {
                 text << ' ';
-                print_fields<S, D, TimePoint, I + 1>(message, text);
+                print_fields<S, D, TimePoint, I + 1, N>(message, text);
             }
         }
 
@@ -0,0 +1,27 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <ufmt/text.hpp>
+
+#include <chronicle/callsites.hpp>
+#include <chronicle/message.hpp>
+
+
+namespace chronicle::fields {
+
+
+    // Signature of the function the message is logged from
+    class function {
+    public:
+        template<class S, typename D, class TimePoint>
+        void print(message<D, TimePoint> const& m, ufmt::basic_text<S>& text) {
+            text << callsites::get(m.callsite_id).function;
+        }
+
+    };   // function
+
+}   // namespace chronicle::fields
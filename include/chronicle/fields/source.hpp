@@ -16,7 +16,7 @@ namespace chronicle::fields {
     public:
         template<class S, typename D, class TimePoint>
         void print(message<D, TimePoint> const& m, ufmt::basic_text<S>& text) {
-            text << '[' << m.source << ']';
+            text << '[' << m.source() << ']';
         }
 
     };   // source
@@ -0,0 +1,47 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+#include <chronicle/severity.hpp>
+
+
+namespace chronicle {
+
+
+    // Zero interval and zero bytes disable the corresponding trigger.
+    // Records with severity up to 'sync_severity' make the backend sync the
+    // sink; sync requests within 'sync_window' are committed together.
+    struct flush_policy {
+        std::chrono::milliseconds interval {0};
+        std::size_t bytes {0};
+        std::optional<severity> sync_severity;
+        std::chrono::milliseconds sync_window {0};
+
+
+        static flush_policy none() noexcept { return {}; }
+
+
+        static flush_policy
+            every(std::chrono::milliseconds interval,
+                  std::size_t bytes = 0) noexcept {
+            return {interval, bytes, std::nullopt, {}};
+        }
+
+
+        static flush_policy durable(
+            std::chrono::milliseconds interval,
+            std::chrono::milliseconds sync_window = {}) noexcept {
+            return {interval, 0, severity::error, sync_window};
+        }
+
+    };   // flush_policy
+
+
+}   // namespace chronicle
@@ -0,0 +1,156 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if !defined(_WIN32)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include <etceteras/expected.hpp>
+
+
+namespace chronicle {
+
+
+    // Read-only view of a byte range of a file, mapped into memory where
+    // mmap is available and read into a buffer otherwise
+    class mapped_file {
+    public:
+        static constexpr auto whole = std::uint64_t(-1);
+
+    private:
+        char const* data_ {nullptr};
+        std::uint64_t size_ {0};
+#if defined(_WIN32)
+        std::unique_ptr<char[]> buffer_;
+#else
+        void* mapping_ {nullptr};
+        std::uint64_t mapping_size_ {0};
+#endif
+
+    public:
+        using expected_mapped_file =
+            etceteras::expected<mapped_file, std::error_code>;
+
+
+        static expected_mapped_file open(std::filesystem::path const& path,
+                                         std::uint64_t offset = 0,
+                                         std::uint64_t size = whole) {
+            std::error_code ec;
+            auto const file_size = std::filesystem::file_size(path, ec);
+            if(ec)
+                return etceteras::make_unexpected(ec);
+            if(offset > file_size)
+                offset = file_size;
+            if(size > file_size - offset)
+                size = file_size - offset;
+            mapped_file mf;
+            if(size == 0)
+                return {std::move(mf)};
+#if defined(_WIN32)
+            FILE* handle = std::fopen(path.string().data(), "rb");
+            if(!handle)
+                return etceteras::make_unexpected(
+                    std::error_code {errno, std::system_category()});
+            mf.buffer_ = std::make_unique<char[]>(size);
+            auto const n =
+                _fseeki64(handle, std::int64_t(offset), SEEK_SET) == 0
+                    ? std::fread(mf.buffer_.get(), 1, size, handle)
+                    : 0;
+            std::fclose(handle);
+            if(n != size)
+                return etceteras::make_unexpected(
+                    std::make_error_code(std::errc::io_error));
+            mf.data_ = mf.buffer_.get();
+#else
+            int const fd = ::open(path.string().data(), O_RDONLY);
+            if(fd == -1)
+                return etceteras::make_unexpected(
+                    std::error_code {errno, std::system_category()});
+            auto const page = std::uint64_t(::sysconf(_SC_PAGESIZE));
+            auto const aligned = offset / page * page;
+            mf.mapping_size_ = size + (offset - aligned);
+            mf.mapping_ = ::mmap(nullptr,
+                                 mf.mapping_size_,
+                                 PROT_READ,
+                                 MAP_SHARED,
+                                 fd,
+                                 off_t(aligned));
+            auto const mmap_errno = errno;
+            ::close(fd);
+            if(mf.mapping_ == MAP_FAILED) {
+                mf.mapping_ = nullptr;
+                return etceteras::make_unexpected(
+                    std::error_code {mmap_errno, std::system_category()});
+            }
+            ::madvise(mf.mapping_, mf.mapping_size_, MADV_SEQUENTIAL);
+            mf.data_ = static_cast<char const*>(mf.mapping_) + (offset - aligned);
+#endif
+            mf.size_ = size;
+            return {std::move(mf)};
+        }
+
+
+        mapped_file() noexcept = default;
+        mapped_file(mapped_file const&) = delete;
+        mapped_file& operator=(mapped_file const&) = delete;
+
+        mapped_file(mapped_file&& other) noexcept { swap(other); }
+
+
+        mapped_file& operator=(mapped_file&& other) noexcept {
+            mapped_file released {std::move(other)};
+            swap(released);
+            return *this;
+        }
+
+
+#if defined(_WIN32)
+        ~mapped_file() = default;
+#else
+        ~mapped_file() {
+            if(mapping_)
+                ::munmap(mapping_, mapping_size_);
+        }
+#endif
+
+
+        char const* data() const noexcept { return data_; }
+        std::uint64_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+
+        std::string_view view() const noexcept {
+            return {data_, std::size_t(size_)};
+        }
+
+
+        void swap(mapped_file& other) noexcept {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+#if defined(_WIN32)
+            std::swap(buffer_, other.buffer_);
+#else
+            std::swap(mapping_, other.mapping_);
+            std::swap(mapping_size_, other.mapping_size_);
+#endif
+        }
+
+    };   // mapped_file
+
+
+}   // namespace chronicle
@@ -6,10 +6,12 @@
 
 
 #include <chrono>
+#include <cstdint>
 #include <string_view>
 
 #include <hydra/sequence.hpp>
 
+#include <chronicle/callsites.hpp>
 #include <chronicle/severity.hpp>
 
 
@@ -22,11 +24,22 @@ namespace chronicle {
         enum severity severity;
         TimePoint time;
         unsigned thread_id;
-        std::string_view source;
-        std::string_view text;
+        std::uint32_t callsite_id {callsites::none};
+        std::uint64_t claimed {0};   // cheap_clock ticks
         bool has_data {false};
+        bool durable {false};
         D data;
 
+
+        std::string_view source() const noexcept {
+            return callsites::get(callsite_id).source;
+        }
+
+
+        std::string_view text() const noexcept {
+            return callsites::get(callsite_id).text;
+        }
+
     };   // message
 
 
@@ -0,0 +1,35 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+// USDT probes of provider 'chronicle', compiled in with -DCHRONICLE_USDT
+// (requires <sys/sdt.h> from systemtap). An enabled probe is a single nop
+// until a tracer attaches to it, a disabled one doesn't evaluate arguments.
+//
+//   claim(sequence, severity)       producer claimed a queue slot
+//   publish(sequence)               producer published it
+//   fetch(sequence)                 backend took it from the queue
+//   batch_start(size)               backend woke up with 'size' messages
+//   batch_end(fetched, bytes)       batch is formatted and written
+//   write_start(bytes)              before sink::write of a batch
+//   write_end(bytes)                after it
+//   rotate_start(day, part)         daily_rotated_file switches files
+//   rotate_end(path, part)          new file is ready
+
+
+#if defined(CHRONICLE_USDT)
+
+#    include <sys/sdt.h>
+
+#    define CHRONICLE_PROBE1(name, a) DTRACE_PROBE1(chronicle, name, a)
+#    define CHRONICLE_PROBE2(name, a, b) DTRACE_PROBE2(chronicle, name, a, b)
+
+#else
+
+#    define CHRONICLE_PROBE1(name, a) ((void)0)
+#    define CHRONICLE_PROBE2(name, a, b) ((void)0)
+
+#endif
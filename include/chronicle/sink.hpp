@@ -31,8 +31,26 @@ namespace chronicle {
 
         virtual void flush() noexcept = 0;
 
+        // Starts a new file if writing 'size' bytes at 'tp' needs one, so
+        // the log can put a part header first. Returns true if it did.
+        virtual bool rotate(time_point const&, size_type) noexcept {
+            return false;
+        }
+
+        // Flushes and asks the OS to put written data on the device.
+        // Returns false if the data could not be made durable.
+        virtual bool sync() noexcept {
+            flush();
+            return true;
+        }
+
         virtual void close() noexcept = 0;
 
+        // Called from a fatal signal handler, returns a descriptor for
+        // write(2) or -1 if there is none. Logs drained on crash flush
+        // sinks after every batch, so nothing is left buffered.
+        virtual int crash_descriptor() noexcept { return -1; }
+
         virtual void prologue(char const* data, size_t size) noexcept = 0;
 
         virtual void epilogue(char const* data, size_t size) noexcept = 0;
@@ -0,0 +1,339 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#if defined(_WIN32)
+#    error circular_file requires POSIX pwrite
+#endif
+
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <etceteras/expected.hpp>
+
+#include <chronicle/sink.hpp>
+
+
+namespace chronicle::sinks {
+
+
+    // Preallocated file of fixed size, output wraps around to the start.
+    // Header keeps head offset, number of wraps and whether the oldest
+    // byte starts a line (host byte order):
+    //   "CHRNRING" | version:4 | data offset:4 | capacity:8 | head:8 |
+    //   generation:8 | starts line:8 | zeros up to data offset
+    class circular_file: public sink {
+    public:
+        static constexpr char magic[8] = {
+            'C', 'H', 'R', 'N', 'R', 'I', 'N', 'G'};
+        static constexpr std::uint32_t version = 1;
+        static constexpr std::uint32_t data_offset = 64;
+
+        struct header {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t data_offset;
+            std::uint64_t capacity;
+            std::uint64_t head;
+            std::uint64_t generation;
+            std::uint64_t starts_line;
+        };   // header
+
+        static_assert(sizeof(header) <= data_offset);
+
+    private:
+        int fd_ {-1};
+        header header_ {};
+
+    public:
+        // Reopens existing file of the same capacity and continues from
+        // its head, otherwise (re)creates it
+        static expected_sink_ptr open(std::filesystem::path const& path,
+                                      std::uint64_t capacity) noexcept {
+            std::error_code ec;
+            circular_file cf {path, capacity, ec};
+            if(!cf.ready())
+                return etceteras::make_unexpected(ec);
+            return {sink_ptr {new circular_file {std::move(cf)}}};
+        }
+
+
+        // Contents in order of writing, starting from a whole line
+        static etceteras::expected<std::string, std::error_code>
+            read(std::filesystem::path const& path) {
+            int const fd = ::open(path.string().data(), O_RDONLY);
+            if(fd == -1)
+                return etceteras::make_unexpected(
+                    std::error_code {errno, std::system_category()});
+            header h;
+            auto ec = read_header(fd, h);
+            if(!ec && !valid(h))
+                ec = std::make_error_code(std::errc::invalid_argument);
+            std::string result;
+            if(!ec) {
+                auto const wrapped = h.generation != 0;
+                result.resize(wrapped ? h.capacity : h.head);
+                auto const tail = wrapped ? h.capacity - h.head : 0;
+                if(wrapped)
+                    ec = read_all(fd,
+                                  result.data(),
+                                  tail,
+                                  off_t(data_offset + h.head));
+                if(!ec)
+                    ec = read_all(fd, result.data() + tail, h.head, data_offset);
+                if(!ec && wrapped && !h.starts_line) {
+                    auto const first_line = result.find('\n');
+                    result.erase(0,
+                                 first_line == std::string::npos
+                                     ? result.size()
+                                     : first_line + 1);
+                }
+            }
+            ::close(fd);
+            if(ec)
+                return etceteras::make_unexpected(ec);
+            return {std::move(result)};
+        }
+
+
+        circular_file() noexcept = default;
+        ~circular_file() override { close(); }
+
+        circular_file(circular_file const&) noexcept = delete;
+        circular_file& operator=(circular_file const&) noexcept = delete;
+
+        circular_file(circular_file&& other) noexcept
+            : fd_ {other.fd_}, header_ {other.header_} {
+            other.fd_ = -1;
+        }
+
+
+        circular_file& operator=(circular_file&& other) noexcept {
+            close();
+            fd_ = other.fd_;
+            header_ = other.header_;
+            other.fd_ = -1;
+            return *this;
+        }
+
+
+        bool ready() const noexcept override { return fd_ != -1; }
+        std::uint64_t capacity() const noexcept { return header_.capacity; }
+        std::uint64_t head() const noexcept { return header_.head; }
+
+        std::uint64_t generation() const noexcept {
+            return header_.generation;
+        }
+
+
+        void write(time_point const&,
+                   char const* data,
+                   size_t size) noexcept override {
+            put(data, size);
+        }
+
+
+        // Data is already in page cache after pwrite
+        void flush() noexcept override {}
+
+
+        // Appending on crash would overwrite the header, so no crash drain
+        int crash_descriptor() noexcept override { return -1; }
+
+
+        bool sync() noexcept override {
+            if(fd_ == -1)
+                return false;
+#if defined(__linux__)
+            return ::fdatasync(fd_) == 0;
+#else
+            return ::fsync(fd_) == 0;
+#endif
+        }
+
+
+        void close() noexcept override {
+            if(fd_ == -1)
+                return;
+            ::close(fd_);
+            fd_ = -1;
+        }
+
+
+        void prologue(const char* data, size_t size) noexcept override {
+            put(data, size);
+        }
+
+
+        void epilogue(const char* data, size_t size) noexcept override {
+            put(data, size);
+        }
+
+
+    private:
+        circular_file(std::filesystem::path const& path,
+                      std::uint64_t capacity,
+                      std::error_code& ec) noexcept {
+            namespace fs = std::filesystem;
+            if(capacity == 0) {
+                ec = std::make_error_code(std::errc::invalid_argument);
+                return;
+            }
+            auto const directory = path.parent_path();
+            if(!directory.empty() && !fs::exists(directory))
+                fs::create_directories(directory, ec);
+            if(!!ec)
+                return;
+
+            int const fd = ::open(path.string().data(), O_RDWR | O_CREAT, 0644);
+            if(fd == -1) {
+                ec = {errno, std::system_category()};
+                return;
+            }
+
+            header existing;
+            if(!read_header(fd, existing) && valid(existing)
+               && existing.capacity == capacity) {
+                fd_ = fd;
+                header_ = existing;
+                return;
+            }
+
+            ec = allocate(fd, data_offset + capacity);
+            if(!ec) {
+                std::memcpy(header_.magic, magic, sizeof(magic));
+                header_.version = version;
+                header_.data_offset = data_offset;
+                header_.capacity = capacity;
+                header_.head = 0;
+                header_.generation = 0;
+                header_.starts_line = 1;
+                char block[data_offset] = {};
+                std::memcpy(block, &header_, sizeof(header_));
+                ec = write_all(fd, block, sizeof(block), 0);
+            }
+            if(ec) {
+                ::close(fd);
+                return;
+            }
+            fd_ = fd;
+        }
+
+
+        static std::error_code allocate(int fd, off_t size) noexcept {
+            if(::ftruncate(fd, size) != 0)
+                return {errno, std::system_category()};
+#if defined(__linux__)
+            // Extent is reserved up front, so writes never fragment it and
+            // a full disk is reported by open instead of a later write
+            if(auto const failed = ::posix_fallocate(fd, 0, size))
+                return {failed, std::system_category()};
+#endif
+            return {};
+        }
+
+
+        static bool valid(header const& h) noexcept {
+            return std::memcmp(h.magic, magic, sizeof(magic)) == 0
+                && h.version == version && h.data_offset == data_offset
+                && h.capacity != 0 && h.head < h.capacity;
+        }
+
+
+        static std::error_code read_header(int fd, header& h) noexcept {
+            return read_all(fd, reinterpret_cast<char*>(&h), sizeof(h), 0);
+        }
+
+
+        static std::error_code read_all(int fd,
+                                        char* data,
+                                        std::uint64_t size,
+                                        off_t offset) noexcept {
+            while(size != 0) {
+                auto const n = ::pread(fd, data, size, offset);
+                if(n == -1 && errno == EINTR)
+                    continue;
+                if(n == -1)
+                    return {errno, std::system_category()};
+                if(n == 0)
+                    return std::make_error_code(std::errc::io_error);
+                data += n;
+                size -= std::uint64_t(n);
+                offset += n;
+            }
+            return {};
+        }
+
+
+        static std::error_code write_all(int fd,
+                                         char const* data,
+                                         std::uint64_t size,
+                                         off_t offset) noexcept {
+            while(size != 0) {
+                auto const n = ::pwrite(fd, data, size, offset);
+                if(n == -1 && errno == EINTR)
+                    continue;
+                if(n == -1)
+                    return {errno, std::system_category()};
+                data += n;
+                size -= std::uint64_t(n);
+                offset += n;
+            }
+            return {};
+        }
+
+
+        void put(char const* data, std::uint64_t size) noexcept {
+            if(fd_ == -1 || size == 0)
+                return;
+            auto const capacity = header_.capacity;
+            // Byte before the oldest one is overwritten now
+            if(size > capacity)
+                header_.starts_line = data[size - capacity - 1] == '\n';
+            else if(header_.generation != 0 || header_.head + size > capacity) {
+                char before = 0;
+                read_all(fd_,
+                         &before,
+                         1,
+                         off_t(data_offset
+                               + (header_.head + size - 1) % capacity));
+                header_.starts_line = before == '\n';
+            }
+            if(size >= capacity) {
+                data += size - capacity;
+                size = capacity;
+            }
+            auto const tail = capacity - header_.head;
+            if(size < tail) {
+                write_all(fd_, data, size, off_t(data_offset + header_.head));
+                header_.head += size;
+            } else {
+                write_all(fd_, data, tail, off_t(data_offset + header_.head));
+                write_all(fd_, data + tail, size - tail, off_t(data_offset));
+                header_.head = size - tail;
+                ++header_.generation;
+            }
+            write_all(fd_,
+                      reinterpret_cast<char const*>(&header_.head),
+                      sizeof(header_.head) + sizeof(header_.generation)
+                          + sizeof(header_.starts_line),
+                      off_t(offsetof(header, head)));
+        }
+
+    };   // circular_file
+
+
+}   // namespace chronicle::sinks
@@ -9,6 +9,7 @@
 #include <memory>
 
 #include <chronicle/sink.hpp>
+#include <chronicle/sinks/sync_file.hpp>
 
 
 namespace chronicle::sinks {
@@ -36,6 +37,11 @@ namespace chronicle::sinks {
         void prologue(const char*, size_t) noexcept override {}
         void epilogue(const char*, size_t) noexcept override {}
 
+
+        int crash_descriptor() noexcept override {
+            return sinks::crash_descriptor(stderr);
+        }
+
     };   // conerr
 
 
@@ -9,6 +9,7 @@
 #include <memory>
 
 #include <chronicle/sink.hpp>
+#include <chronicle/sinks/sync_file.hpp>
 
 
 namespace chronicle::sinks {
@@ -31,11 +32,16 @@ namespace chronicle::sinks {
         }
 
 
-        void flush() noexcept override {}
+        void flush() noexcept override { fflush(stdout); }
         void close() noexcept override {}
         void prologue(const char*, size_t) noexcept override {}
         void epilogue(const char*, size_t) noexcept override {}
 
+
+        int crash_descriptor() noexcept override {
+            return sinks::crash_descriptor(stdout);
+        }
+
     };   // conout
 
 
@@ -6,22 +6,57 @@
 
 
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <utility>
 
 #include <ufmt/print.hpp>
 #include <ufmt/text.hpp>
 
+#include <chronicle/probes.hpp>
 #include <chronicle/sink.hpp>
+#include <chronicle/sinks/gzip.hpp>
+#include <chronicle/sinks/housekeeper.hpp>
+#include <chronicle/sinks/retention.hpp>
+#include <chronicle/sinks/sync_file.hpp>
+#include <chronicle/sinks/time_index.hpp>
 
 
 namespace chronicle::sinks {
 
 
     class daily_rotated_file: public sink {
+    public:
+        // Next file is opened in background this long before midnight
+        static constexpr auto prepare_lead = std::chrono::minutes {1};
+
+    private:
+        struct prepared_file {
+            FILE* handle {nullptr};
+            index_writer index;
+            std::filesystem::path path;
+            std::size_t written {0};
+            uint64_t day {0};
+            unsigned part {1};
+            bool created {false};
+        };   // prepared_file
+
+
+        // Hands the file opened by housekeeper over to backend
+        struct handoff {
+            std::mutex mutex;
+            std::condition_variable done;
+            bool pending {false};
+            prepared_file file;
+        };   // handoff
+
+
         FILE* handle_ {nullptr};
         std::filesystem::path directory_;
         std::filesystem::path base_name_;
@@ -31,12 +66,29 @@ namespace chronicle::sinks {
         unsigned part_ {1};
         std::size_t limit_ {0};
         std::size_t written_ {0};
+        time_point next_rotation_ {};
+        time_point prepare_from_ {};
+        bool prepare_requested_ {false};
+        enum compression compression_ {compression::none};
+        index_writer index_;
+        std::unique_ptr<handoff> handoff_;
+        std::unique_ptr<housekeeper> housekeeper_;
+        std::unique_ptr<housekeeper> compressor_;
+        std::unique_ptr<retained_files> retained_;
 
     public:
-        static expected_sink_ptr open(std::filesystem::path const& path,
-                                      std::size_t limit = 0) {
+        // Rotated files are compressed by a low priority thread if requested,
+        // old ones are removed by housekeeper according to retention. Each
+        // file may have a sidecar time index.
+        static expected_sink_ptr
+            open(std::filesystem::path const& path,
+                 std::size_t limit = 0,
+                 enum compression compression = compression::none,
+                 retention const& retention = {},
+                 index_policy index = index_policy::none()) {
             std::error_code ec;
-            daily_rotated_file drf {path, limit, ec};
+            daily_rotated_file drf {
+                path, limit, compression, retention, index, ec};
             if(!drf.ready())
                 return etceteras::make_unexpected(ec);
             return {sink_ptr {new daily_rotated_file {std::move(drf)}}};
@@ -63,14 +115,22 @@ namespace chronicle::sinks {
               log_day_ {other.log_day_},
               part_ {other.part_},
               limit_ {other.limit_},
-              written_ {other.written_} {
+              written_ {other.written_},
+              next_rotation_ {other.next_rotation_},
+              prepare_from_ {other.prepare_from_},
+              prepare_requested_ {other.prepare_requested_},
+              compression_ {other.compression_},
+              index_ {std::move(other.index_)},
+              handoff_ {std::move(other.handoff_)},
+              housekeeper_ {std::move(other.housekeeper_)},
+              compressor_ {std::move(other.compressor_)},
+              retained_ {std::move(other.retained_)} {
             other.handle_ = nullptr;
         }
 
 
         daily_rotated_file& operator=(daily_rotated_file&& other) noexcept {
-            if(handle_ != nullptr)
-                std::fclose(handle_);
+            close();
             handle_ = other.handle_;
             other.handle_ = nullptr;
             directory_ = std::move(other.directory_);
@@ -81,6 +141,15 @@ namespace chronicle::sinks {
             part_ = other.part_;
             limit_ = other.limit_;
             written_ = other.written_;
+            next_rotation_ = other.next_rotation_;
+            prepare_from_ = other.prepare_from_;
+            prepare_requested_ = other.prepare_requested_;
+            compression_ = other.compression_;
+            index_ = std::move(other.index_);
+            handoff_ = std::move(other.handoff_);
+            housekeeper_ = std::move(other.housekeeper_);
+            compressor_ = std::move(other.compressor_);
+            retained_ = std::move(other.retained_);
             return *this;
         }
 
@@ -93,37 +162,67 @@ namespace chronicle::sinks {
                    size_t size) noexcept override {
             if(!handle_)
                 return;
-            using namespace std::chrono;
-            std::error_code ec;
-            auto const now_day = uint64_t(
-                duration_cast<hours>(tp.time_since_epoch()).count() / 24);
-            if(now_day != log_day_) {
-                log_day_ = now_day;
-                part_ = 1;
-                rotate_file(tp, ec);
-            } else if(limit_ != 0 && written_ + size > limit_) {
-                ++part_;
-                rotate_file(tp, ec);
+            if(!rotate(tp, size) && !prepare_requested_) {
+                if(tp >= prepare_from_)
+                    prepare(log_day_ + 1, 1);
+                else if(limit_ != 0 && written_ + size > limit_ / 4 * 3)
+                    prepare(log_day_, part_ + 1);
             }
 
+            if(!handle_)
+                return;
+
+            index_.add(tp, written_);
             std::fwrite(data, sizeof(char), size, handle_);
 
             written_ += size;
         }
 
 
+        bool rotate(time_point const& tp, size_t size) noexcept override {
+            if(!handle_)
+                return false;
+            std::error_code ec;
+            if(tp >= next_rotation_) {
+                log_day_ = day_of(tp);
+                part_ = 1;
+            } else if(limit_ != 0 && written_ + size > limit_)
+                ++part_;
+            else
+                return false;
+            rotate_file(tp, ec);
+            return true;
+        }
+
+
         void flush() noexcept override {
             if(!handle_)
                 return;
             std::fflush(handle_);
+            index_.flush();
+        }
+
+
+        bool sync() noexcept override { return sync_file(handle_); }
+
+
+        int crash_descriptor() noexcept override {
+            return sinks::crash_descriptor(handle_);
         }
 
 
         void close() noexcept override {
-            if(!handle_)
-                return;
-            std::fclose(handle_);
-            handle_ = nullptr;
+            if(handle_) {
+                std::fclose(handle_);
+                handle_ = nullptr;
+            }
+            index_.close();
+            if(handoff_)
+                discard(std::move(*take_prepared(true)));
+            if(housekeeper_)
+                housekeeper_->stop();
+            if(compressor_)
+                compressor_->stop();
         }
 
 
@@ -131,6 +230,7 @@ namespace chronicle::sinks {
             if(!handle_)
                 return;
             std::fwrite(data, sizeof(char), size, handle_);
+            written_ += size;
         }
 
 
@@ -138,13 +238,22 @@ namespace chronicle::sinks {
             if(!handle_)
                 return;
             std::fwrite(data, sizeof(char), size, handle_);
+            written_ += size;
         }
 
 
     private:
         daily_rotated_file(std::filesystem::path const& path,
                            std::size_t limit,
-                           std::error_code& ec) noexcept {
+                           enum compression compression,
+                           retention const& retention,
+                           index_policy index,
+                           std::error_code& ec) noexcept
+            : compression_ {compression},
+              index_ {index},
+              handoff_ {std::make_unique<handoff>()},
+              housekeeper_ {std::make_unique<housekeeper>()},
+              compressor_ {std::make_unique<housekeeper>(true)} {
             namespace fs = std::filesystem;
             directory_ = path.parent_path();
             if(!directory_.empty() && !fs::exists(directory_)) {
@@ -154,34 +263,162 @@ namespace chronicle::sinks {
                 return;
             base_name_ = path.stem();
             extension_ = path.extension();
-            namespace chr = std::chrono;
-            auto const now = chr::system_clock::now();
-            log_day_ =
-                chr::duration_cast<chr::hours>(now.time_since_epoch()).count()
-                / 24;
+            auto const now = std::chrono::system_clock::now();
+            log_day_ = day_of(now);
             limit_ = limit;
             rotate_file(now, ec);
+            if(!handle_ || !retention.limited())
+                return;
+            // Scanned here, backend may create next files before housekeeper
+            // gets to it
+            retained_ = std::make_unique<retained_files>(retention);
+            retained_->scan(directory_, base_name_, extension_, file_path_);
+            housekeeper_->post(
+                [retained = retained_.get()] { retained->enforce(); });
         }
 
 
-        void rotate_file(std::chrono::system_clock::time_point tp,
-                         std::error_code& ec) {
-            if(handle_)
-                std::fclose(handle_);
+        static uint64_t day_of(time_point const& tp) noexcept {
             namespace chr = std::chrono;
-            auto const dp = chr::floor<chr::days>(tp);
-            auto const ymd = chr::year_month_day {dp};
-            auto suffix = ufmt::text {};
-            suffix << '-' << int(ymd.year()) << '_';
-            if(unsigned(ymd.month()) < 10)
-                suffix << '0';
-            suffix << unsigned(ymd.month()) << '_';
-            if(unsigned(ymd.day()) < 10)
-                suffix << '0';
-            suffix << unsigned(ymd.day());
-            auto full_path_without_part = directory_;
-            full_path_without_part /= base_name_;
-            full_path_without_part += suffix.string();
+            return uint64_t(
+                chr::duration_cast<chr::hours>(tp.time_since_epoch()).count()
+                / 24);
+        }
+
+
+        static time_point start_of(uint64_t day) noexcept {
+            return time_point {std::chrono::hours {24 * day}};
+        }
+
+
+        // Opens next file on housekeeper, backend only swaps handles
+        void prepare(uint64_t day, unsigned part) {
+            prepare_requested_ = true;
+            {
+                std::lock_guard lock {handoff_->mutex};
+                handoff_->pending = true;
+            }
+            housekeeper_->post([h = handoff_.get(),
+                                without_part = path_without_part(day),
+                                extension = extension_,
+                                limit = limit_,
+                                index = index_.policy(),
+                                day,
+                                part] {
+                prepared_file f;
+                f.index = index_writer {index};
+                f.day = day;
+                f.part = part;
+                while(!fits_to_open(f.path,
+                                    without_part,
+                                    f.part,
+                                    limit,
+                                    f.written,
+                                    extension))
+                    ++f.part;
+                std::error_code ec;
+                f.created = !std::filesystem::exists(f.path, ec);
+                f.handle = std::fopen(f.path.string().data(), "a+b");
+                if(f.handle)
+                    f.index.open(f.path);
+
+                std::unique_lock lock {h->mutex};
+                auto stale = std::exchange(h->file, std::move(f));
+                h->pending = false;
+                lock.unlock();
+                h->done.notify_all();
+                discard(std::move(stale));
+            });
+        }
+
+
+        // Without waiting nothing is taken while the file is being opened
+        std::optional<prepared_file> take_prepared(bool wait) {
+            std::unique_lock lock {handoff_->mutex};
+            if(wait)
+                handoff_->done.wait(lock, [this] { return !handoff_->pending; });
+            else if(handoff_->pending)
+                return std::nullopt;
+            return std::exchange(handoff_->file, prepared_file {});
+        }
+
+
+        static void discard(prepared_file f) noexcept {
+            if(!f.handle)
+                return;
+            std::fclose(f.handle);
+            f.index.close();
+            if(!f.created)
+                return;
+            std::error_code ec;
+            if(std::filesystem::file_size(f.path, ec) == 0 && !ec) {
+                std::filesystem::remove(f.path, ec);
+                std::filesystem::remove(index_path(f.path), ec);
+            }
+        }
+
+
+        void retire(FILE* handle, std::filesystem::path const& path) {
+            auto* const compressor =
+                compression_ == compression::gzip ? compressor_.get() : nullptr;
+            housekeeper_->post(
+                [handle,
+                 index = index_.release(),
+                 path,
+                 compressor,
+                 retained = retained_.get()] {
+                    std::fclose(handle);
+                    if(index)
+                        std::fclose(index);
+                    if(retained) {
+                        retained->add(path);
+                        retained->enforce();
+                    }
+                    if(!compressor)
+                        return;
+                    compressor->post([path, retained] {
+                        if(!gzip_file(path) && retained)
+                            retained->compressed(path);
+                    });
+                });
+        }
+
+
+        void rotate_file(time_point, std::error_code& ec) {
+            CHRONICLE_PROBE2(rotate_start, log_day_, part_);
+            auto retired = std::filesystem::path {};
+            if(handle_) {
+                retired = file_path_;
+                retire(handle_, file_path_);
+                handle_ = nullptr;
+            }
+
+            next_rotation_ = start_of(log_day_ + 1);
+            prepare_from_ = next_rotation_ - prepare_lead;
+
+            // Backend doesn't wait for housekeeper, it opens the file itself
+            // and takes the pending one on next rotation
+            auto taken = take_prepared(false);
+            prepare_requested_ = !taken;
+            if(taken) {
+                auto& prepared = *taken;
+                if(prepared.handle && prepared.day == log_day_
+                   && prepared.part >= part_) {
+                    handle_ = prepared.handle;
+                    index_ = std::move(prepared.index);
+                    file_path_ = std::move(prepared.path);
+                    written_ = prepared.written;
+                    part_ = prepared.part;
+                    CHRONICLE_PROBE2(rotate_end, file_path_.c_str(), part_);
+                    return;
+                }
+                // Retired file may still be buffered, its size tells nothing
+                if(prepared.path == retired)
+                    prepared.created = false;
+                discard(std::move(prepared));
+            }
+
+            auto const full_path_without_part = path_without_part(log_day_);
 
             while(!fits_to_open(file_path_,
                                 full_path_without_part,
@@ -196,6 +433,27 @@ namespace chronicle::sinks {
                 ec = {errno, std::system_category()};
                 return;
             }
+            index_.open(file_path_);
+            CHRONICLE_PROBE2(rotate_end, file_path_.c_str(), part_);
+        }
+
+
+        std::filesystem::path path_without_part(uint64_t day) const {
+            namespace chr = std::chrono;
+            auto const dp = chr::floor<chr::days>(start_of(day));
+            auto const ymd = chr::year_month_day {dp};
+            auto suffix = ufmt::text {};
+            suffix << '-' << int(ymd.year()) << '_';
+            if(unsigned(ymd.month()) < 10)
+                suffix << '0';
+            suffix << unsigned(ymd.month()) << '_';
+            if(unsigned(ymd.day()) < 10)
+                suffix << '0';
+            suffix << unsigned(ymd.day());
+            auto full_path_without_part = directory_;
+            full_path_without_part /= base_name_;
+            full_path_without_part += suffix.string();
+            return full_path_without_part;
         }
 
 
@@ -218,6 +476,10 @@ namespace chronicle::sinks {
             }
             file_path += extension;
             auto ec = std::error_code {};
+            auto compressed = file_path;
+            compressed += ".gz";
+            if(fs::exists(compressed, ec))
+                return false;
             auto const file_size = fs::file_size(file_path, ec);
             if(ec) {
                 written = 0;
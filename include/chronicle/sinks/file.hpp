@@ -11,6 +11,8 @@
 #include <system_error>
 
 #include <chronicle/sink.hpp>
+#include <chronicle/sinks/sync_file.hpp>
+#include <chronicle/sinks/time_index.hpp>
 
 
 namespace chronicle::sinks {
@@ -18,12 +20,15 @@ namespace chronicle::sinks {
 
     class file: public sink {
         FILE* handle_ {nullptr};
+        std::uint64_t offset_ {0};
+        index_writer index_;
 
     public:
         static expected_sink_ptr
-            open(std::filesystem::path const& path) noexcept {
+            open(std::filesystem::path const& path,
+                 index_policy index = index_policy::none()) noexcept {
             std::error_code ec;
-            file f {path, ec};
+            file f {path, index, ec};
             if(!f.ready())
                 return etceteras::make_unexpected(ec);
             return {sink_ptr {new file {std::move(f)}}};
@@ -36,7 +41,10 @@ namespace chronicle::sinks {
         file(file const&) noexcept = delete;
         file& operator=(file const&) noexcept = delete;
 
-        file(file&& other) noexcept: handle_ {other.handle_} {
+        file(file&& other) noexcept
+            : handle_ {other.handle_},
+              offset_ {other.offset_},
+              index_ {std::move(other.index_)} {
             other.handle_ = nullptr;
         }
 
@@ -46,6 +54,8 @@ namespace chronicle::sinks {
                 std::fclose(handle_);
             handle_ = other.handle_;
             other.handle_ = nullptr;
+            offset_ = other.offset_;
+            index_ = std::move(other.index_);
             return *this;
         }
 
@@ -53,12 +63,14 @@ namespace chronicle::sinks {
         bool ready() const noexcept override { return handle_ != nullptr; }
 
 
-        void write(time_point const&,
+        void write(time_point const& tp,
                    char const* data,
                    size_t size) noexcept override {
             if(!handle_)
                 return;
+            index_.add(tp, offset_);
             std::fwrite(data, sizeof(char), size, handle_);
+            offset_ += size;
         }
 
 
@@ -66,6 +78,15 @@ namespace chronicle::sinks {
             if(!handle_)
                 return;
             std::fflush(handle_);
+            index_.flush();
+        }
+
+
+        bool sync() noexcept override { return sync_file(handle_); }
+
+
+        int crash_descriptor() noexcept override {
+            return sinks::crash_descriptor(handle_);
         }
 
 
@@ -74,6 +95,7 @@ namespace chronicle::sinks {
                 return;
             std::fclose(handle_);
             handle_ = nullptr;
+            index_.close();
         }
 
 
@@ -81,6 +103,7 @@ namespace chronicle::sinks {
             if(!handle_)
                 return;
             std::fwrite(data, sizeof(char), size, handle_);
+            offset_ += size;
         }
 
 
@@ -88,12 +111,15 @@ namespace chronicle::sinks {
             if(!handle_)
                 return;
             std::fwrite(data, sizeof(char), size, handle_);
+            offset_ += size;
         }
 
 
     private:
         file(std::filesystem::path const& path,
-             std::error_code& error) noexcept {
+             index_policy index,
+             std::error_code& error) noexcept
+            : index_ {index} {
             auto const directory = path.parent_path();
             namespace fs = std::filesystem;
             if(!directory.empty() && !fs::exists(directory))
@@ -101,8 +127,17 @@ namespace chronicle::sinks {
             if(!!error)
                 return;
             handle_ = std::fopen(path.string().data(), "a+b");
-            if(handle_ == nullptr)
+            if(handle_ == nullptr) {
                 error = {errno, std::system_category()};
+                return;
+            }
+            offset_ = fs::file_size(path, error);
+            if(!error)
+                error = index_.open(path);
+            if(!error)
+                return;
+            std::fclose(handle_);
+            handle_ = nullptr;
         }
 
     };   // file
@@ -0,0 +1,328 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+#include <chronicle/sinks/sync_file.hpp>
+
+
+namespace chronicle::sinks {
+
+
+    enum class compression { none, gzip };
+
+
+    // Streaming gzip (RFC 1952) writer: LZ77 with hash chains and fixed
+    // Huffman codes. Log text compresses well enough with it and there
+    // are no dependencies.
+    class gzip_writer {
+        static constexpr std::size_t window_size = 32768;
+        static constexpr std::size_t buffer_size = 2 * window_size;
+        static constexpr std::size_t hash_size = 1 << 15;
+        static constexpr std::size_t min_match = 3;
+        static constexpr std::size_t max_match = 258;
+        static constexpr std::size_t lookahead = max_match + min_match + 1;
+        static constexpr int max_chain = 32;
+        static constexpr std::size_t output_chunk = 64 * 1024;
+
+        static constexpr std::array<std::uint16_t, 29> length_base {
+            3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+            31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static constexpr std::array<std::uint8_t, 29> length_extra {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+            2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static constexpr std::array<std::uint16_t, 30> distance_base {
+            1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+            33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+            1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        static constexpr std::array<std::uint8_t, 30> distance_extra {
+            0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+            6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+        std::vector<std::uint8_t> window_;
+        std::vector<std::int64_t> head_;
+        std::vector<std::int64_t> previous_;
+        std::vector<std::uint8_t> output_;
+        std::int64_t base_ {0};
+        std::size_t position_ {0};
+        std::size_t end_ {0};
+        std::uint64_t bits_ {0};
+        unsigned bit_count_ {0};
+        std::uint32_t crc_ {0xFFFFFFFFu};
+        std::uint32_t input_size_ {0};
+
+    public:
+        gzip_writer()
+            : window_(buffer_size),
+              head_(hash_size, -1),
+              previous_(window_size, -1) {
+            output_.reserve(output_chunk + 64);
+        }
+
+
+        std::error_code compress(FILE* in, FILE* out) {
+            static constexpr std::uint8_t header[] = {
+                0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 3};
+            if(std::fwrite(header, 1, sizeof(header), out) != sizeof(header))
+                return {errno, std::system_category()};
+
+            // One open-ended block, closed by an empty final one
+            put_bits(0b010, 3);
+            bool eof = false;
+            for(;;) {
+                if(!eof && end_ - position_ < lookahead) {
+                    if(auto const ec = fill(in, eof); ec)
+                        return ec;
+                }
+                if(position_ == end_)
+                    break;
+                encode_next();
+                if(output_.size() >= output_chunk)
+                    if(auto const ec = drain(out); ec)
+                        return ec;
+            }
+            put_symbol(256);
+            put_bits(0b011, 3);
+            put_symbol(256);
+            if(bit_count_ != 0)
+                put_bits(0, 8 - bit_count_);
+
+            put_word(crc_ ^ 0xFFFFFFFFu);
+            put_word(input_size_);
+            return drain(out);
+        }
+
+    private:
+        static std::uint32_t crc32(std::uint32_t crc,
+                                   std::uint8_t const* data,
+                                   std::size_t size) noexcept {
+            static constexpr auto table = [] {
+                std::array<std::uint32_t, 256> t {};
+                for(std::uint32_t i = 0; i != 256; ++i) {
+                    auto c = i;
+                    for(int k = 0; k != 8; ++k)
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    t[i] = c;
+                }
+                return t;
+            }();
+            for(std::size_t i = 0; i != size; ++i)
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return crc;
+        }
+
+
+        std::error_code fill(FILE* in, bool& eof) {
+            while(end_ - position_ < lookahead) {
+                if(end_ == buffer_size) {
+                    // position_ is past window_size here, keep one window
+                    std::memmove(window_.data(),
+                                 window_.data() + window_size,
+                                 window_size);
+                    base_ += window_size;
+                    position_ -= window_size;
+                    end_ -= window_size;
+                }
+                auto const n = std::fread(window_.data() + end_,
+                                          1,
+                                          buffer_size - end_,
+                                          in);
+                if(n == 0) {
+                    if(std::ferror(in))
+                        return {errno, std::system_category()};
+                    eof = true;
+                    return {};
+                }
+                crc_ = crc32(crc_, window_.data() + end_, n);
+                input_size_ += std::uint32_t(n);
+                end_ += n;
+            }
+            return {};
+        }
+
+
+        std::size_t hash_at(std::size_t i) const noexcept {
+            return ((std::size_t(window_[i]) << 10)
+                    ^ (std::size_t(window_[i + 1]) << 5) ^ window_[i + 2])
+                 & (hash_size - 1);
+        }
+
+
+        // Returns the previous head of the chain
+        std::int64_t insert(std::size_t i) noexcept {
+            auto const h = hash_at(i);
+            auto const absolute = base_ + std::int64_t(i);
+            auto const candidate = head_[h];
+            previous_[std::size_t(absolute) & (window_size - 1)] = candidate;
+            head_[h] = absolute;
+            return candidate;
+        }
+
+
+        void encode_next() {
+            auto const available = end_ - position_;
+            if(available < min_match) {
+                put_symbol(window_[position_++]);
+                return;
+            }
+
+            auto const absolute = base_ + std::int64_t(position_);
+            auto candidate = insert(position_);
+            auto const limit = available < max_match ? available : max_match;
+            std::size_t best_length = 0;
+            std::size_t best_distance = 0;
+            for(int chain = max_chain; chain != 0 && candidate >= base_
+                && absolute - candidate <= std::int64_t(window_size);
+                --chain) {
+                auto const* a = window_.data() + (candidate - base_);
+                auto const* b = window_.data() + position_;
+                if(a[best_length] == b[best_length]) {
+                    std::size_t length = 0;
+                    while(length != limit && a[length] == b[length])
+                        ++length;
+                    if(length > best_length) {
+                        best_length = length;
+                        best_distance = std::size_t(absolute - candidate);
+                        if(length == limit)
+                            break;
+                    }
+                }
+                auto const next =
+                    previous_[std::size_t(candidate) & (window_size - 1)];
+                if(next >= candidate)
+                    break;
+                candidate = next;
+            }
+
+            if(best_length < min_match) {
+                put_symbol(window_[position_++]);
+                return;
+            }
+
+            put_match(best_length, best_distance);
+            auto const last = position_ + best_length;
+            for(++position_; position_ != last; ++position_)
+                if(end_ - position_ >= min_match)
+                    insert(position_);
+        }
+
+
+        void put_match(std::size_t length, std::size_t distance) {
+            std::size_t code = 0;
+            while(code + 1 != length_base.size()
+                  && length_base[code + 1] <= length)
+                ++code;
+            put_symbol(257 + unsigned(code));
+            put_bits(std::uint32_t(length - length_base[code]),
+                     length_extra[code]);
+
+            code = 0;
+            while(code + 1 != distance_base.size()
+                  && distance_base[code + 1] <= distance)
+                ++code;
+            put_bits(reversed(std::uint32_t(code), 5), 5);
+            put_bits(std::uint32_t(distance - distance_base[code]),
+                     distance_extra[code]);
+        }
+
+
+        // Fixed literal/length code from RFC 1951, 3.2.6
+        void put_symbol(unsigned symbol) {
+            if(symbol < 144)
+                put_bits(reversed(0x30 + symbol, 8), 8);
+            else if(symbol < 256)
+                put_bits(reversed(0x190 + symbol - 144, 9), 9);
+            else if(symbol < 280)
+                put_bits(reversed(symbol - 256, 7), 7);
+            else
+                put_bits(reversed(0xC0 + symbol - 280, 8), 8);
+        }
+
+
+        static std::uint32_t reversed(std::uint32_t code,
+                                      unsigned length) noexcept {
+            std::uint32_t result = 0;
+            for(unsigned i = 0; i != length; ++i, code >>= 1)
+                result = (result << 1) | (code & 1);
+            return result;
+        }
+
+
+        void put_bits(std::uint32_t value, unsigned count) {
+            bits_ |= std::uint64_t(value) << bit_count_;
+            bit_count_ += count;
+            while(bit_count_ >= 8) {
+                output_.push_back(std::uint8_t(bits_));
+                bits_ >>= 8;
+                bit_count_ -= 8;
+            }
+        }
+
+
+        void put_word(std::uint32_t value) {
+            for(int i = 0; i != 4; ++i, value >>= 8)
+                output_.push_back(std::uint8_t(value));
+        }
+
+
+        std::error_code drain(FILE* out) {
+            if(std::fwrite(output_.data(), 1, output_.size(), out)
+               != output_.size())
+                return {errno, std::system_category()};
+            output_.clear();
+            return {};
+        }
+
+    };   // gzip_writer
+
+
+    // Compresses 'path' into 'path.gz' through a temporary file, then
+    // removes the original
+    inline std::error_code gzip_file(std::filesystem::path const& path) {
+        namespace fs = std::filesystem;
+        auto compressed = path;
+        compressed += ".gz";
+        auto temporary = compressed;
+        temporary += ".tmp";
+
+        FILE* in = std::fopen(path.string().data(), "rb");
+        if(!in)
+            return {errno, std::system_category()};
+        FILE* out = std::fopen(temporary.string().data(), "wb");
+        if(!out) {
+            auto const ec = std::error_code {errno, std::system_category()};
+            std::fclose(in);
+            return ec;
+        }
+
+        auto ec = gzip_writer {}.compress(in, out);
+        if(!ec && !sync_file(out))
+            ec = {errno, std::system_category()};
+        std::fclose(in);
+        if(std::fclose(out) != 0 && !ec)
+            ec = {errno, std::system_category()};
+
+        if(!ec)
+            fs::rename(temporary, compressed, ec);
+        if(ec) {
+            std::error_code ignored;
+            fs::remove(temporary, ignored);
+            return ec;
+        }
+        fs::remove(path, ec);
+        return ec;
+    }
+
+
+}   // namespace chronicle::sinks
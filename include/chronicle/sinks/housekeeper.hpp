@@ -0,0 +1,139 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+
+#if defined(_WIN32)
+
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+
+#    include <windows.h>
+
+#elif defined(__APPLE__)
+
+#    include <pthread.h>
+#    include <sys/qos.h>
+
+#else
+
+#    include <pthread.h>
+#    include <sched.h>
+
+#endif
+
+
+namespace chronicle::sinks {
+
+
+    // Lowers priority of the calling thread so it runs only when CPU is idle
+    inline void run_in_background() noexcept {
+#if defined(_WIN32)
+        SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(__APPLE__)
+        pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#elif defined(SCHED_IDLE)
+        sched_param param {};
+        pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+    }
+
+
+    // Runs file maintenance (opening, closing, ...) off the backend thread,
+    // the thread is started with the first task
+    class housekeeper {
+    public:
+        using task_type = std::function<void()>;
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable wakeup_;
+        std::condition_variable idle_;
+        std::deque<task_type> tasks_;
+        bool stopping_ {false};
+        bool busy_ {false};
+        bool background_ {false};
+        std::thread thread_;
+
+    public:
+        housekeeper() noexcept = default;
+        explicit housekeeper(bool background) noexcept
+            : background_ {background} {}
+        housekeeper(housekeeper const&) = delete;
+        housekeeper& operator=(housekeeper const&) = delete;
+        ~housekeeper() { stop(); }
+
+
+        void post(task_type task) {
+            {
+                std::lock_guard lock {mutex_};
+                tasks_.push_back(std::move(task));
+                if(!thread_.joinable()) {
+                    stopping_ = false;
+                    thread_ = std::thread {[this] { run(); }};
+                }
+            }
+            wakeup_.notify_one();
+        }
+
+
+        // Blocks until all posted tasks are done
+        void wait() {
+            std::unique_lock lock {mutex_};
+            idle_.wait(lock, [this] { return tasks_.empty() && !busy_; });
+        }
+
+
+        // Runs remaining tasks and joins the thread
+        void stop() {
+            {
+                std::lock_guard lock {mutex_};
+                if(!thread_.joinable())
+                    return;
+                stopping_ = true;
+            }
+            wakeup_.notify_one();
+            thread_.join();
+        }
+
+    private:
+        void run() {
+            if(background_)
+                run_in_background();
+            std::unique_lock lock {mutex_};
+            for(;;) {
+                wakeup_.wait(lock,
+                             [this] { return stopping_ || !tasks_.empty(); });
+                if(tasks_.empty())
+                    return;
+                auto task = std::move(tasks_.front());
+                tasks_.pop_front();
+                busy_ = true;
+                lock.unlock();
+                task();
+                lock.lock();
+                busy_ = false;
+                if(tasks_.empty())
+                    idle_.notify_all();
+            }
+        }
+
+    };   // housekeeper
+
+
+}   // namespace chronicle::sinks
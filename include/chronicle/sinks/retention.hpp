@@ -0,0 +1,185 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <system_error>
+
+
+namespace chronicle::sinks {
+
+
+    // Limits for rotated files, zero means unlimited. The file being
+    // written is never removed and is not counted.
+    struct retention {
+        std::size_t files {0};
+        std::uintmax_t bytes {0};
+        std::chrono::hours age {0};
+
+
+        bool limited() const noexcept {
+            return files != 0 || bytes != 0 || age.count() != 0;
+        }
+
+    };   // retention
+
+
+    // Rotated files from oldest to newest. Directory is scanned once,
+    // after that only files reported by the sink are tracked.
+    class retained_files {
+        struct entry {
+            std::filesystem::path path;
+            std::uintmax_t size {0};
+            std::filesystem::file_time_type time;
+        };   // entry
+
+        retention retention_;
+        mutable std::mutex mutex_;
+        std::deque<entry> entries_;
+        std::uintmax_t bytes_ {0};
+
+    public:
+        explicit retained_files(retention const& r) noexcept
+            : retention_ {r} {}
+
+
+        // Picks up '<stem>-<date>*<extension>' and the same with '.gz'
+        void scan(std::filesystem::path const& directory,
+                  std::filesystem::path const& stem,
+                  std::filesystem::path const& extension,
+                  std::filesystem::path const& current) {
+            namespace fs = std::filesystem;
+            auto const prefix = stem.string() + '-';
+            auto const plain = extension.string();
+            auto const archived = plain + ".gz";
+            std::error_code ec;
+            std::deque<entry> found;
+            for(auto it = fs::directory_iterator {
+                    directory.empty() ? fs::path {"."} : directory, ec};
+                !ec && it != fs::directory_iterator {};
+                it.increment(ec)) {
+                auto const& file = *it;
+                auto const name = file.path().filename().string();
+                if(!name.starts_with(prefix) || name.size() == prefix.size()
+                   || name[prefix.size()] < '0' || name[prefix.size()] > '9'
+                   || !(name.ends_with(plain) || name.ends_with(archived)))
+                    continue;
+                std::error_code file_ec;
+                if(fs::equivalent(file.path(), current, file_ec))
+                    continue;
+                auto const size = file.file_size(file_ec);
+                if(file_ec)
+                    continue;
+                auto const time = file.last_write_time(file_ec);
+                if(file_ec)
+                    continue;
+                found.push_back({file.path(), size, time});
+            }
+            std::sort(found.begin(),
+                      found.end(),
+                      [](entry const& x, entry const& y) {
+                          return x.time < y.time;
+                      });
+
+            std::lock_guard lock {mutex_};
+            for(auto& e: found)
+                bytes_ += e.size;
+            found.insert(found.end(),
+                         std::make_move_iterator(entries_.begin()),
+                         std::make_move_iterator(entries_.end()));
+            entries_ = std::move(found);
+        }
+
+
+        void add(std::filesystem::path const& path) {
+            std::error_code ec;
+            auto const size = std::filesystem::file_size(path, ec);
+            if(ec)
+                return;
+            std::lock_guard lock {mutex_};
+            entries_.push_back(
+                {path, size, std::filesystem::file_time_type::clock::now()});
+            bytes_ += size;
+        }
+
+
+        // 'path' was replaced by 'path.gz'
+        void compressed(std::filesystem::path const& path) {
+            namespace fs = std::filesystem;
+            auto gz = path;
+            gz += ".gz";
+            std::error_code ec;
+            std::lock_guard lock {mutex_};
+            auto const it = std::find_if(entries_.begin(),
+                                         entries_.end(),
+                                         [&](entry const& e) {
+                                             return e.path == path;
+                                         });
+            if(it == entries_.end()) {
+                // Expired while being compressed
+                fs::remove(gz, ec);
+                return;
+            }
+            auto const size = fs::file_size(gz, ec);
+            if(ec)
+                return;
+            bytes_ -= it->size;
+            bytes_ += size;
+            it->path = std::move(gz);
+            it->size = size;
+        }
+
+
+        void enforce() {
+            auto const now = std::filesystem::file_time_type::clock::now();
+            std::lock_guard lock {mutex_};
+            while(!entries_.empty() && expired(entries_.front(), now)) {
+                auto const& path = entries_.front().path;
+                auto sidecar = path;
+                if(sidecar.extension() == ".gz")
+                    sidecar.replace_extension();
+                sidecar += ".idx";
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+                std::filesystem::remove(sidecar, ec);
+                bytes_ -= entries_.front().size;
+                entries_.pop_front();
+            }
+        }
+
+
+        std::size_t size() const {
+            std::lock_guard lock {mutex_};
+            return entries_.size();
+        }
+
+
+        std::uintmax_t bytes() const {
+            std::lock_guard lock {mutex_};
+            return bytes_;
+        }
+
+    private:
+        bool expired(entry const& oldest,
+                     std::filesystem::file_time_type now) const noexcept {
+            if(retention_.files != 0 && entries_.size() > retention_.files)
+                return true;
+            if(retention_.bytes != 0 && bytes_ > retention_.bytes)
+                return true;
+            return retention_.age.count() != 0
+                && oldest.time + retention_.age < now;
+        }
+
+    };   // retained_files
+
+
+}   // namespace chronicle::sinks
@@ -0,0 +1,273 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#if !defined(_WIN32)
+#    include <unistd.h>
+#endif
+
+#include <chronicle/sink.hpp>
+
+
+namespace chronicle::sinks {
+
+
+    // Preallocated memory keeping the most recent 'capacity' bytes of
+    // formatted output. Shared between ring sink and whoever dumps it.
+    class flight_recorder {
+        std::unique_ptr<char[]> data_;
+        std::size_t capacity_ {0};
+        std::size_t head_ {0};
+        bool wrapped_ {false};
+        // Byte before the oldest one, already overwritten, was a line end
+        bool starts_line_ {true};
+        mutable std::mutex mutex_;
+#if !defined(_WIN32)
+        static constexpr int max_signal = 65;
+        // Write ends of the pipes by signal number, shifted by one
+        static inline std::atomic<int> signal_pipes_[max_signal] {};
+
+        int signal_ {0};
+        int pipe_[2] {-1, -1};
+        struct sigaction previous_ {};
+        std::filesystem::path dump_path_;
+        std::thread watcher_;
+#endif
+
+    public:
+        explicit flight_recorder(std::size_t capacity)
+            : data_ {std::make_unique<char[]>(capacity)},
+              capacity_ {capacity} {}
+
+        flight_recorder(flight_recorder const&) = delete;
+        flight_recorder& operator=(flight_recorder const&) = delete;
+
+#if defined(_WIN32)
+        ~flight_recorder() = default;
+#else
+        ~flight_recorder() { stop_dumping(); }
+#endif
+
+        std::size_t capacity() const noexcept { return capacity_; }
+
+
+        std::size_t size() const noexcept {
+            std::lock_guard lock {mutex_};
+            return wrapped_ ? capacity_ : head_;
+        }
+
+
+        void clear() noexcept {
+            std::lock_guard lock {mutex_};
+            head_ = 0;
+            wrapped_ = false;
+            starts_line_ = true;
+        }
+
+
+        void write(char const* data, std::size_t size) noexcept {
+            if(capacity_ == 0 || size == 0)
+                return;
+            std::lock_guard lock {mutex_};
+            if(size > capacity_)
+                starts_line_ = data[size - capacity_ - 1] == '\n';
+            else if(wrapped_ || head_ + size > capacity_)
+                starts_line_ = data_[(head_ + size - 1) % capacity_] == '\n';
+            if(size >= capacity_) {
+                data += size - capacity_;
+                size = capacity_;
+            }
+            auto const tail = capacity_ - head_;
+            if(size < tail) {
+                std::memcpy(data_.get() + head_, data, size);
+                head_ += size;
+                return;
+            }
+            std::memcpy(data_.get() + head_, data, tail);
+            std::memcpy(data_.get(), data + tail, size - tail);
+            head_ = size - tail;
+            wrapped_ = true;
+        }
+
+
+        // Contents in order of writing, starting from a whole line
+        std::string snapshot() const {
+            std::string result;
+            {
+                std::lock_guard lock {mutex_};
+                if(!wrapped_)
+                    return std::string {data_.get(), head_};
+                result.reserve(capacity_);
+                result.append(data_.get() + head_, capacity_ - head_);
+                result.append(data_.get(), head_);
+                if(starts_line_)
+                    return result;
+            }
+            auto const first_line = result.find('\n');
+            if(first_line == std::string::npos)
+                return {};
+            result.erase(0, first_line + 1);
+            return result;
+        }
+
+
+        std::error_code dump(std::filesystem::path const& path) const {
+            auto const contents = snapshot();
+            FILE* handle = std::fopen(path.string().data(), "wb");
+            if(!handle)
+                return {errno, std::system_category()};
+            std::error_code ec;
+            if(std::fwrite(contents.data(), 1, contents.size(), handle)
+               != contents.size())
+                ec = {errno, std::system_category()};
+            if(std::fclose(handle) != 0 && !ec)
+                ec = {errno, std::system_category()};
+            return ec;
+        }
+
+
+#if !defined(_WIN32)
+
+        // Dumps to 'path' each time the process receives 'signal'. The
+        // handler only writes to a pipe, dumping runs on a watcher thread.
+        std::error_code dump_on(int signal, std::filesystem::path path) {
+            if(signal <= 0 || signal >= max_signal)
+                return std::make_error_code(std::errc::invalid_argument);
+            if(watcher_.joinable())
+                return std::make_error_code(std::errc::device_or_resource_busy);
+            int expected = 0;
+            if(::pipe(pipe_) != 0)
+                return {errno, std::system_category()};
+            if(!signal_pipes_[signal].compare_exchange_strong(expected,
+                                                               pipe_[1] + 1)) {
+                close_pipe();
+                return std::make_error_code(std::errc::device_or_resource_busy);
+            }
+
+            struct sigaction action {};
+            action.sa_handler = &on_signal;
+            sigemptyset(&action.sa_mask);
+            action.sa_flags = SA_RESTART;
+            if(::sigaction(signal, &action, &previous_) != 0) {
+                auto const ec = std::error_code {errno, std::system_category()};
+                signal_pipes_[signal].store(0);
+                close_pipe();
+                return ec;
+            }
+
+            signal_ = signal;
+            dump_path_ = std::move(path);
+            watcher_ = std::thread {[this] {
+                char command;
+                while(::read(pipe_[0], &command, 1) == 1 && command != 0)
+                    dump(dump_path_);
+            }};
+
+            return {};
+        }
+
+
+        void stop_dumping() noexcept {
+            if(!watcher_.joinable())
+                return;
+            ::sigaction(signal_, &previous_, nullptr);
+            signal_pipes_[signal_].store(0);
+            char const stop = 0;
+            while(::write(pipe_[1], &stop, 1) == -1 && errno == EINTR)
+                ;
+            watcher_.join();
+            close_pipe();
+            signal_ = 0;
+        }
+
+    private:
+        static void on_signal(int signal) {
+            auto const saved_errno = errno;
+            int const fd = signal_pipes_[signal].load() - 1;
+            char const command = 1;
+            if(fd != -1) {
+                auto const written = ::write(fd, &command, 1);
+                (void)written;
+            }
+            errno = saved_errno;
+        }
+
+
+        void close_pipe() noexcept {
+            ::close(pipe_[0]);
+            ::close(pipe_[1]);
+            pipe_[0] = pipe_[1] = -1;
+        }
+
+#endif
+
+    };   // flight_recorder
+
+
+    class ring: public sink {
+        std::shared_ptr<flight_recorder> recorder_;
+
+    public:
+        static expected_sink_ptr
+            open(std::shared_ptr<flight_recorder> recorder) noexcept {
+            if(!recorder)
+                return etceteras::make_unexpected(
+                    std::make_error_code(std::errc::invalid_argument));
+            return {sink_ptr {new ring {std::move(recorder)}}};
+        }
+
+
+        ring() noexcept = default;
+
+        explicit ring(std::shared_ptr<flight_recorder> recorder) noexcept
+            : recorder_ {std::move(recorder)} {}
+
+
+        bool ready() const noexcept override { return !!recorder_; }
+
+
+        void write(time_point const&,
+                   char const* data,
+                   size_t size) noexcept override {
+            if(!recorder_)
+                return;
+            recorder_->write(data, size);
+        }
+
+
+        void flush() noexcept override {}
+        void close() noexcept override {}
+
+
+        void prologue(const char* data, size_t size) noexcept override {
+            if(!recorder_)
+                return;
+            recorder_->write(data, size);
+        }
+
+
+        void epilogue(const char* data, size_t size) noexcept override {
+            if(!recorder_)
+                return;
+            recorder_->write(data, size);
+        }
+
+    };   // ring
+
+
+}   // namespace chronicle::sinks
@@ -0,0 +1,52 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <cstdio>
+
+
+#if defined(_WIN32)
+
+#    include <io.h>
+
+#else
+
+#    include <unistd.h>
+
+#endif
+
+
+namespace chronicle::sinks {
+
+
+    inline bool sync_file(FILE* handle) noexcept {
+        if(!handle)
+            return false;
+        if(std::fflush(handle) != 0)
+            return false;
+#if defined(_WIN32)
+        return _commit(_fileno(handle)) == 0;
+#elif defined(__linux__)
+        return fdatasync(fileno(handle)) == 0;
+#else
+        return fsync(fileno(handle)) == 0;
+#endif
+    }
+
+
+    // Descriptor for a fatal signal handler, neither the stream nor its
+    // lock is touched
+    inline int crash_descriptor(FILE* handle) noexcept {
+#if defined(_WIN32)
+        (void)handle;
+        return -1;
+#else
+        return handle ? fileno(handle) : -1;
+#endif
+    }
+
+
+}   // namespace chronicle::sinks
@@ -0,0 +1,216 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+
+#include <etceteras/expected.hpp>
+
+#include <chronicle/mapped_file.hpp>
+#include <chronicle/sink.hpp>
+
+
+namespace chronicle::sinks {
+
+
+    // Sparse sidecar index '<file>.idx' of fixed size entries in host
+    // byte order. An entry is written before the batch starting at
+    // 'offset', everything before 'offset' was written by 'time'.
+    struct index_entry {
+        std::int64_t time;   // microseconds since epoch
+        std::uint64_t offset;
+        std::uint64_t ordinal;   // batches written since the file was opened
+    };   // index_entry
+
+
+    // Entry is added when 'bytes' were written or 'interval' passed since
+    // the previous one, zeros disable the index
+    struct index_policy {
+        std::uint64_t bytes {0};
+        std::chrono::milliseconds interval {0};
+
+
+        static index_policy none() noexcept { return {}; }
+
+
+        static index_policy
+            every(std::uint64_t bytes,
+                  std::chrono::milliseconds interval = {}) noexcept {
+            return {bytes, interval};
+        }
+
+
+        bool enabled() const noexcept {
+            return bytes != 0 || interval.count() != 0;
+        }
+
+    };   // index_policy
+
+
+    inline std::filesystem::path index_path(std::filesystem::path path) {
+        path += ".idx";
+        return path;
+    }
+
+
+    inline std::int64_t index_time(sink::time_point tp) noexcept {
+        namespace chr = std::chrono;
+        return chr::duration_cast<chr::microseconds>(tp.time_since_epoch())
+            .count();
+    }
+
+
+    class index_writer {
+        FILE* handle_ {nullptr};
+        index_policy policy_;
+        std::int64_t last_time_ {0};
+        std::uint64_t last_offset_ {0};
+        std::uint64_t ordinal_ {0};
+        bool empty_ {true};
+
+    public:
+        index_writer() noexcept = default;
+        explicit index_writer(index_policy policy) noexcept
+            : policy_ {policy} {}
+        index_writer(index_writer const&) = delete;
+        index_writer& operator=(index_writer const&) = delete;
+        ~index_writer() { close(); }
+
+
+        index_writer(index_writer&& other) noexcept
+            : handle_ {other.handle_},
+              policy_ {other.policy_},
+              last_time_ {other.last_time_},
+              last_offset_ {other.last_offset_},
+              ordinal_ {other.ordinal_},
+              empty_ {other.empty_} {
+            other.handle_ = nullptr;
+        }
+
+
+        index_writer& operator=(index_writer&& other) noexcept {
+            close();
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+            policy_ = other.policy_;
+            last_time_ = other.last_time_;
+            last_offset_ = other.last_offset_;
+            ordinal_ = other.ordinal_;
+            empty_ = other.empty_;
+            return *this;
+        }
+
+
+        index_policy const& policy() const noexcept { return policy_; }
+        bool enabled() const noexcept { return policy_.enabled(); }
+        bool ready() const noexcept { return handle_ != nullptr; }
+
+
+        // Index of the log file 'path', appended to if exists
+        std::error_code open(std::filesystem::path const& path) noexcept {
+            close();
+            if(!enabled())
+                return {};
+            handle_ = std::fopen(index_path(path).string().data(), "ab");
+            if(!handle_)
+                return {errno, std::system_category()};
+            empty_ = true;
+            ordinal_ = 0;
+            return {};
+        }
+
+
+        void close() noexcept {
+            if(!handle_)
+                return;
+            std::fclose(handle_);
+            handle_ = nullptr;
+        }
+
+
+        // Caller closes the handle, policy is kept for the next file
+        FILE* release() noexcept {
+            auto* const handle = handle_;
+            handle_ = nullptr;
+            return handle;
+        }
+
+
+        void flush() noexcept {
+            if(handle_)
+                std::fflush(handle_);
+        }
+
+
+        // Called for every batch before it is written at 'offset'
+        void add(sink::time_point tp, std::uint64_t offset) noexcept {
+            if(!handle_)
+                return;
+            auto const time = index_time(tp);
+            auto const interval = std::int64_t(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    policy_.interval)
+                    .count());
+            if(empty_
+               || (policy_.bytes != 0
+                   && offset - last_offset_ >= policy_.bytes)
+               || (interval != 0 && time - last_time_ >= interval)) {
+                auto const entry = index_entry {time, offset, ordinal_};
+                std::fwrite(&entry, sizeof(entry), 1, handle_);
+                last_time_ = time;
+                last_offset_ = offset;
+                empty_ = false;
+            }
+            ++ordinal_;
+        }
+
+    };   // index_writer
+
+
+    // Maps the part of 'path' that may contain records logged in
+    // [from, to). A record is expected to be written within 'lag' after
+    // its time, records queued for longer may fall outside.
+    inline etceteras::expected<mapped_file, std::error_code>
+        map_time_range(std::filesystem::path const& path,
+                       sink::time_point from,
+                       sink::time_point to,
+                       std::chrono::milliseconds lag =
+                           std::chrono::seconds {1}) {
+        auto expected_index = mapped_file::open(index_path(path));
+        if(!expected_index)
+            return etceteras::make_unexpected(expected_index.error());
+        auto const& index = *expected_index;
+        auto const* first =
+            reinterpret_cast<index_entry const*>(index.data());
+        auto const* last = first + index.size() / sizeof(index_entry);
+
+        // Batches before an entry older than 'from' can't hold the range
+        auto const begin_time = index_time(from);
+        auto const after_begin = std::partition_point(
+            first, last, [&](index_entry const& e) {
+                return e.time < begin_time;
+            });
+        auto const begin =
+            after_begin == first ? std::uint64_t(0) : (after_begin - 1)->offset;
+
+        auto const end_time = index_time(to + lag);
+        auto const after_end = std::partition_point(
+            first, last, [&](index_entry const& e) {
+                return e.time <= end_time;
+            });
+        if(after_end == last)
+            return mapped_file::open(path, begin);
+        auto const end = std::max(after_end->offset, begin);
+        return mapped_file::open(path, begin, end - begin);
+    }
+
+
+}   // namespace chronicle::sinks
@@ -0,0 +1,32 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <cstddef>
+#include <source_location>
+#include <string_view>
+
+
+namespace chronicle {
+
+
+    // Tag of a logging call, converted implicitly from a string literal
+    // and capturing location of the call
+    struct source_tag {
+        std::string_view name;
+        std::source_location location;
+
+
+        template<std::size_t N>
+        constexpr source_tag(char const (&tag)[N],
+                             std::source_location location =
+                                 std::source_location::current()) noexcept
+            : name {tag, N - 1}, location {location} {}
+
+    };   // source_tag
+
+
+}   // namespace chronicle
@@ -0,0 +1,167 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+
+namespace chronicle {
+
+
+    // Snapshot of log counters since construction. Counters are read one
+    // by one, so a snapshot taken while the log runs isn't exactly coherent.
+    struct stats {
+        static constexpr std::size_t batch_buckets = 32;
+        static constexpr std::size_t residence_buckets = 48;
+
+        std::uint64_t enqueued {0};    // messages claimed by producers
+        std::uint64_t dropped {0};     // not claimed: never opened or halted
+        std::uint64_t blocks {0};      // producers waiting on a full queue
+        std::uint64_t processed {0};   // messages taken by backend
+        std::uint64_t batches {0};
+        // [i] is the number of batches of 2^i to 2^(i+1)-1 messages
+        std::array<std::uint64_t, batch_buckets> batch_sizes {};
+        std::uint64_t bytes_written {0};
+        std::chrono::nanoseconds format_time {0};
+        std::chrono::nanoseconds write_time {0};   // in sink::write
+        // most messages in the queue seen by backend at start of a batch,
+        // including ones of producers waiting for a slot
+        std::uint64_t high_watermark {0};
+        std::uint64_t occupancy {0};        // messages in the queue
+        // [i] is the number of messages that waited 2^i to 2^(i+1)-1 ns
+        // from claim to backend
+        std::array<std::uint64_t, residence_buckets> residence {};
+        std::chrono::nanoseconds max_residence {0};
+
+
+        // Upper bound of the bucket, 'p' is from 0 to 100
+        std::chrono::nanoseconds residence_percentile(double p) const noexcept {
+            return std::chrono::nanoseconds {log2_percentile(residence, p)};
+        }
+
+
+        template<std::size_t N>
+        static std::uint64_t
+            log2_percentile(std::array<std::uint64_t, N> const& buckets,
+                            double p) noexcept {
+            std::uint64_t total = 0;
+            for(auto const n: buckets)
+                total += n;
+            if(total == 0)
+                return 0;
+            auto const rank = std::uint64_t(double(total) * p / 100.);
+            std::uint64_t seen = 0;
+            for(std::size_t i = 0; i != N; ++i) {
+                seen += buckets[i];
+                if(seen > rank || seen == total)
+                    return (std::uint64_t(2) << i) - 1;
+            }
+            return 0;
+        }
+
+    };   // stats
+
+
+    // Backend part of stats. Each counter has a single writer, so it is
+    // updated with relaxed load and store, readers never block it.
+    class backend_stats {
+        using counter = std::atomic<std::uint64_t>;
+
+        counter processed_ {0};
+        counter batches_ {0};
+        std::array<counter, stats::batch_buckets> batch_sizes_ {};
+        counter bytes_written_ {0};
+        counter format_time_ {0};
+        counter write_time_ {0};
+        counter high_watermark_ {0};
+        std::array<counter, stats::residence_buckets> residence_ {};
+        counter max_residence_ {0};
+        counter interval_max_residence_ {0};
+
+    public:
+        // 'enqueued' is read at start of a batch, when every message taken
+        // before was counted as processed
+        void batch_started(std::uint64_t enqueued) noexcept {
+            auto const processed = processed_.load(std::memory_order_relaxed);
+            auto const queued = enqueued > processed ? enqueued - processed : 0;
+            if(queued > high_watermark_.load(std::memory_order_relaxed))
+                high_watermark_.store(queued, std::memory_order_relaxed);
+        }
+
+
+        void message_waited(std::uint64_t nanoseconds) noexcept {
+            add(residence_[bucket_of(nanoseconds, stats::residence_buckets)], 1);
+            if(nanoseconds > max_residence_.load(std::memory_order_relaxed))
+                max_residence_.store(nanoseconds, std::memory_order_relaxed);
+            if(nanoseconds
+               > interval_max_residence_.load(std::memory_order_relaxed))
+                interval_max_residence_.store(nanoseconds,
+                                              std::memory_order_relaxed);
+        }
+
+
+        // Longest residence since the previous call, backend only
+        std::chrono::nanoseconds take_interval_max_residence() noexcept {
+            auto const max =
+                interval_max_residence_.load(std::memory_order_relaxed);
+            interval_max_residence_.store(0, std::memory_order_relaxed);
+            return std::chrono::nanoseconds {max};
+        }
+
+
+        void batch_processed(std::uint64_t size,
+                             std::uint64_t bytes,
+                             std::chrono::nanoseconds format_time,
+                             std::chrono::nanoseconds write_time) noexcept {
+            add(processed_, size);
+            add(batches_, 1);
+            add(batch_sizes_[bucket_of(size, stats::batch_buckets)], 1);
+            add(bytes_written_, bytes);
+            add(format_time_, std::uint64_t(format_time.count()));
+            add(write_time_, std::uint64_t(write_time.count()));
+        }
+
+
+        void read(stats& s) const noexcept {
+            auto const load = [](counter const& c) {
+                return c.load(std::memory_order_relaxed);
+            };
+            s.processed = load(processed_);
+            s.batches = load(batches_);
+            for(std::size_t i = 0; i != stats::batch_buckets; ++i)
+                s.batch_sizes[i] = load(batch_sizes_[i]);
+            s.bytes_written = load(bytes_written_);
+            s.format_time = std::chrono::nanoseconds {load(format_time_)};
+            s.write_time = std::chrono::nanoseconds {load(write_time_)};
+            s.high_watermark = load(high_watermark_);
+            for(std::size_t i = 0; i != stats::residence_buckets; ++i)
+                s.residence[i] = load(residence_[i]);
+            s.max_residence = std::chrono::nanoseconds {load(max_residence_)};
+        }
+
+    private:
+        static std::size_t bucket_of(std::uint64_t value,
+                                     std::size_t buckets) noexcept {
+            auto const bucket =
+                value == 0 ? 0 : std::size_t(std::bit_width(value)) - 1;
+            return (std::min)(bucket, buckets - 1);
+        }
+
+
+        static void add(counter& c, std::uint64_t n) noexcept {
+            c.store(c.load(std::memory_order_relaxed) + n,
+                    std::memory_order_relaxed);
+        }
+
+    };   // backend_stats
+
+
+}   // namespace chronicle
@@ -37,26 +37,25 @@ namespace chronicle {
         structured_log& operator=(structured_log const&) = delete;
 
 
-        template<size_t N1, size_t N2>
-        void failure(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void failure(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::failure>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1,
-                 size_t N2,
+        template<size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
-        void failure(char const (&tag)[N1],
+        void failure(source_tag tag,
                      char const (&text)[N2],
                      char const (&name)[N3],
                      Arg&& value,
                      Attrs&&... attrs) {
             this->template print<severity::failure>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -64,29 +63,28 @@ namespace chronicle {
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R failure_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R failure_with(R&& r, source_tag tag, char const (&text)[N2]) {
             base::template print<severity::failure>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
             return std::forward<R>(r);
         }
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
         R failure_with(R&& r,
-                       char const (&tag)[N1],
+                       source_tag tag,
                        char const (&text)[N2],
                        char const (&name)[N3],
                        Arg&& value,
                        Attrs&&... attrs) {
             this->template print<severity::failure>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -96,26 +94,25 @@ namespace chronicle {
 
 
 
-        template<size_t N1, size_t N2>
-        void error(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void error(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1,
-                 size_t N2,
+        template<size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
-        void error(char const (&tag)[N1],
+        void error(source_tag tag,
                    char const (&text)[N2],
                    char const (&name)[N3],
                    Arg&& value,
                    Attrs&&... attrs) {
             this->template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -123,29 +120,28 @@ namespace chronicle {
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R error_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R error_with(R&& r, source_tag tag, char const (&text)[N2]) {
             base::template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
             return std::forward<R>(r);
         }
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
         R error_with(R&& r,
-                     char const (&tag)[N1],
+                     source_tag tag,
                      char const (&text)[N2],
                      char const (&name)[N3],
                      Arg&& value,
                      Attrs&&... attrs) {
             this->template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -155,26 +151,25 @@ namespace chronicle {
 
 
 
-        template<size_t N1, size_t N2>
-        void warning(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void warning(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::warning>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1,
-                 size_t N2,
+        template<size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
-        void warning(char const (&tag)[N1],
+        void warning(source_tag tag,
                      char const (&text)[N2],
                      char const (&name)[N3],
                      Arg&& value,
                      Attrs&&... attrs) {
             this->template print<severity::warning>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -182,29 +177,28 @@ namespace chronicle {
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R warning_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R warning_with(R&& r, source_tag tag, char const (&text)[N2]) {
             base::template print<severity::warning>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
             return std::forward<R>(r);
         }
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
         R warning_with(R&& r,
-                       char const (&tag)[N1],
+                       source_tag tag,
                        char const (&text)[N2],
                        char const (&name)[N3],
                        Arg&& value,
                        Attrs&&... attrs) {
             this->template print<severity::warning>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -214,26 +208,25 @@ namespace chronicle {
 
 
 
-        template<size_t N1, size_t N2>
-        void info(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void info(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::info>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1,
-                 size_t N2,
+        template<size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
-        void info(char const (&tag)[N1],
+        void info(source_tag tag,
                   char const (&text)[N2],
                   char const (&name)[N3],
                   Arg&& value,
                   Attrs&&... attrs) {
             this->template print<severity::info>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -241,29 +234,28 @@ namespace chronicle {
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R info_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R info_with(R&& r, source_tag tag, char const (&text)[N2]) {
             base::template print<severity::info>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
             return std::forward<R>(r);
         }
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
         R info_with(R&& r,
-                    char const (&tag)[N1],
+                    source_tag tag,
                     char const (&text)[N2],
                     char const (&name)[N3],
                     Arg&& value,
                     Attrs&&... attrs) {
             this->template print<severity::info>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -271,28 +263,52 @@ namespace chronicle {
             return std::forward<R>(r);
         }
 
+        template<size_t N2>
+        completion info_durable(source_tag tag,
+                                char const (&text)[N2]) {
+            return base::template print_durable<severity::info>(
+                tag,
+                std::string_view {text, N2 - 1});
+        }
+
+
+        template<size_t N2,
+                 size_t N3,
+                 typename Arg,
+                 typename... Attrs>
+        completion info_durable(source_tag tag,
+                                char const (&text)[N2],
+                                char const (&name)[N3],
+                                Arg&& value,
+                                Attrs&&... attrs) {
+            return this->template print_durable<severity::info>(
+                tag,
+                std::string_view {text, N2 - 1},
+                std::string_view {name, N3 - 1},
+                std::forward<Arg>(value),
+                std::forward<Attrs>(attrs)...);
+        }
 
 
-        template<size_t N1, size_t N2>
-        void extra(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void extra(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::extra>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1,
-                 size_t N2,
+        template<size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
-        void extra(char const (&tag)[N1],
+        void extra(source_tag tag,
                    char const (&text)[N2],
                    char const (&name)[N3],
                    Arg&& value,
                    Attrs&&... attrs) {
             this->template print<severity::extra>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -300,29 +316,28 @@ namespace chronicle {
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R extra_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R extra_with(R&& r, source_tag tag, char const (&text)[N2]) {
             base::template print<severity::extra>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
             return std::forward<R>(r);
         }
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
         R extra_with(R&& r,
-                     char const (&tag)[N1],
+                     source_tag tag,
                      char const (&text)[N2],
                      char const (&name)[N3],
                      Arg&& value,
                      Attrs&&... attrs) {
             this->template print<severity::extra>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -332,26 +347,25 @@ namespace chronicle {
 
 
 
-        template<size_t N1, size_t N2>
-        void trace(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void trace(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::trace>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1,
-                 size_t N2,
+        template<size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
-        void trace(char const (&tag)[N1],
+        void trace(source_tag tag,
                    char const (&text)[N2],
                    char const (&name)[N3],
                    Arg&& value,
                    Attrs&&... attrs) {
             this->template print<severity::trace>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -359,29 +373,28 @@ namespace chronicle {
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R trace_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R trace_with(R&& r, source_tag tag, char const (&text)[N2]) {
             base::template print<severity::trace>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
             return std::forward<R>(r);
         }
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
         R trace_with(R&& r,
-                     char const (&tag)[N1],
+                     source_tag tag,
                      char const (&text)[N2],
                      char const (&name)[N3],
                      Arg&& value,
                      Attrs&&... attrs) {
             this->template print<severity::trace>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -394,36 +407,34 @@ namespace chronicle {
 #ifdef NDEBUG
 
 
-        template<size_t N1, size_t N2>
-        void debug(char const (&)[N1], char const (&)[N2]) {}
+        template<size_t N2>
+        void debug(source_tag, char const (&)[N2]) {}
 
 
-        template<size_t N1,
-                 size_t N2,
+        template<size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
-        void debug(char const (&)[N1],
+        void debug(source_tag,
                    char const (&)[N2],
                    char const (&)[N3],
                    Arg&&,
                    Attrs&&...) {}
 
 
-        template<typename R, size_t N1, size_t N2>
-        R debug_with(R&& r, char const (&)[N1], char const (&)[N2]) {
+        template<typename R, size_t N2>
+        R debug_with(R&& r, source_tag, char const (&)[N2]) {
             return std::forward<R>(r);
         }
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
         R debug_with(R&& r,
-                     char const (&)[N1],
+                     source_tag,
                      char const (&)[N2],
                      char const (&)[N3],
                      Arg&&,
@@ -435,26 +446,25 @@ namespace chronicle {
 #else
 
 
-        template<size_t N1, size_t N2>
-        void debug(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void debug(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::debug>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<size_t N1,
-                 size_t N2,
+        template<size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
-        void debug(char const (&tag)[N1],
+        void debug(source_tag tag,
                    char const (&text)[N2],
                    char const (&name)[N3],
                    Arg&& value,
                    Attrs&&... attrs) {
             this->template print<severity::debug>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -462,29 +472,28 @@ namespace chronicle {
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R debug_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R debug_with(R&& r, source_tag tag, char const (&text)[N2]) {
             base::template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
             return std::forward<R>(r);
         }
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  size_t N3,
                  typename Arg,
                  typename... Attrs>
         R debug_with(R&& r,
-                     char const (&tag)[N1],
+                     source_tag tag,
                      char const (&text)[N2],
                      char const (&name)[N3],
                      Arg&& value,
                      Attrs&&... attrs) {
             this->template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::string_view {name, N3 - 1},
                 std::forward<Arg>(value),
@@ -498,16 +507,50 @@ namespace chronicle {
 
     private:
         template<chronicle::severity S, typename Arg, typename... Attrs>
-        void print(std::string_view const& tag,
+        void print(source_tag const& tag,
                    std::string_view const& text,
                    std::string_view const& name,
                    Arg&& value,
                    Attrs&&... attrs) {
-            if(base::severity() < S)
+            message_type* m = compose<S>(tag,
+                                         text,
+                                         name,
+                                         std::forward<Arg>(value),
+                                         std::forward<Attrs>(attrs)...);
+            if(!m)
                 return;
+            base::publish(*m);
+        }
+
+
+        template<chronicle::severity S, typename Arg, typename... Attrs>
+        completion print_durable(source_tag const& tag,
+                                 std::string_view const& text,
+                                 std::string_view const& name,
+                                 Arg&& value,
+                                 Attrs&&... attrs) {
+            message_type* m = compose<S>(tag,
+                                         text,
+                                         name,
+                                         std::forward<Arg>(value),
+                                         std::forward<Attrs>(attrs)...);
+            if(!m)
+                return {};
+            return base::publish_durable(*m);
+        }
+
+
+        template<chronicle::severity S, typename Arg, typename... Attrs>
+        message_type* compose(source_tag const& tag,
+                              std::string_view const& text,
+                              std::string_view const& name,
+                              Arg&& value,
+                              Attrs&&... attrs) {
+            if(base::threshold() < S)
+                return nullptr;
             message_type* m = base::template claim<S>(tag, text);
             if(!m)
-                return;
+                return nullptr;
             m->data.clear();
             m->data << ' ';
             format_args(*m,
@@ -515,7 +558,7 @@ namespace chronicle {
                         std::forward<Arg>(value),
                         std::forward<Attrs>(attrs)...);
             m->has_data = true;
-            base::publish(*m);
+            return m;
         }
 
 
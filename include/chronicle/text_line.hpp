@@ -0,0 +1,107 @@
+// This file is part of chronicle library
+// Copyright 2020-2024 Andrei Ilin <ortfero@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+
+namespace chronicle {
+
+
+    // Fields of a line written by chronicle::fields::format, e.g.
+    //   "[E] 2020-05-09 16:57:02.343402 #14648 [main] Some message"
+    // Time may be without date, thread and source may be absent.
+    // Timestamps of the same layout compare chronologically as strings.
+    struct text_line {
+        char marker {' '};   // 'F', 'E', 'W', 'T', 'D' or ' '
+        std::string_view time;
+        std::string_view thread;
+        std::string_view source;
+        std::string_view text;
+
+
+        // 'line' is without trailing '\n'
+        static bool parse(std::string_view line, text_line& parsed) noexcept {
+            if(line.size() < 4 || line[3] != ' ')
+                return false;
+            if(line[0] == '[' && line[2] == ']')
+                parsed.marker = line[1];
+            else if(line.substr(0, 3) == "   ")
+                parsed.marker = ' ';
+            else
+                return false;
+            line.remove_prefix(4);
+
+            auto const is_digit = [](char c) { return c >= '0' && c <= '9'; };
+            auto time_size = line.find(' ');
+            if(line.size() > 11 && is_digit(line[0]) && line[4] == '-'
+               && line[7] == '-' && line[10] == ' ')
+                time_size = line.find(' ', 11);
+            if(time_size == 0 || !is_digit(line[0]))
+                return false;
+            parsed.time = line.substr(0, time_size);
+            line.remove_prefix(parsed.time.size());
+            if(!line.empty())
+                line.remove_prefix(1);
+
+            parsed.thread = {};
+            if(!line.empty() && line[0] == '#') {
+                parsed.thread = line.substr(1, line.find(' ') - 1);
+                line.remove_prefix(
+                    std::min(line.size(), parsed.thread.size() + 2));
+            }
+
+            parsed.source = {};
+            if(!line.empty() && line[0] == '[') {
+                auto const end = line.find(']');
+                if(end == std::string_view::npos)
+                    return false;
+                parsed.source = line.substr(1, end - 1);
+                line.remove_prefix(std::min(line.size(), end + 2));
+            }
+
+            parsed.text = line;
+            return true;
+        }
+
+
+        // Severity marker by name: "failure" -> 'F', "info" -> ' ', ...
+        static bool marker_of(std::string_view severity, char& marker) noexcept {
+            constexpr std::pair<std::string_view, char> markers[] = {
+                {"failure", 'F'},
+                {"error", 'E'},
+                {"warning", 'W'},
+                {"info", ' '},
+                {"extra", ' '},
+                {"trace", 'T'},
+                {"debug", 'D'}};
+            for(auto const& [name, m]: markers)
+                if(name == severity) {
+                    marker = m;
+                    return true;
+                }
+            return false;
+        }
+
+
+        // Lower is more severe, as with chronicle::severity
+        static int rank(char marker) noexcept {
+            switch(marker) {
+            case 'F': return 0;
+            case 'E': return 1;
+            case 'W': return 2;
+            case 'T': return 5;
+            case 'D': return 6;
+            default: return 3;
+            }
+        }
+
+    };   // text_line
+
+
+}   // namespace chronicle
@@ -36,28 +36,28 @@ namespace chronicle {
         text_log& operator=(text_log const&) = delete;
 
 
-        template<size_t N1, size_t N2>
-        void failure(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void failure(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::failure>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R failure_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R failure_with(R&& r, source_tag tag, char const (&text)[N2]) {
             failure(tag, text);
             return std::forward<R>(r);
         }
 
 
-        template<size_t N1, size_t N2, typename Arg, typename... Args>
-        void failure(char const (&tag)[N1],
+        template<size_t N2, typename Arg, typename... Args>
+        void failure(source_tag tag,
                      char const (&text)[N2],
                      Arg&& arg,
                      Args&&... args) {
             this->template print<severity::failure>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::forward<Arg>(arg),
                 std::forward<Args>(args)...);
@@ -65,12 +65,11 @@ namespace chronicle {
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  typename Arg,
                  typename... Args>
         R failure_with(R&& r,
-                       char const (&tag)[N1],
+                       source_tag tag,
                        char const (&text)[N2],
                        Arg&& arg,
                        Args&&... args) {
@@ -82,28 +81,28 @@ namespace chronicle {
         }
 
 
-        template<size_t N1, size_t N2>
-        void error(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void error(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R error_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R error_with(R&& r, source_tag tag, char const (&text)[N2]) {
             error(tag, text);
             return std::forward<R>(r);
         }
 
 
-        template<size_t N1, size_t N2, typename Arg, typename... Args>
-        void error(char const (&tag)[N1],
+        template<size_t N2, typename Arg, typename... Args>
+        void error(source_tag tag,
                    char const (&text)[N2],
                    Arg&& arg,
                    Args&&... args) {
             this->template print<severity::error>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::forward<Arg>(arg),
                 std::forward<Args>(args)...);
@@ -111,12 +110,11 @@ namespace chronicle {
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  typename Arg,
                  typename... Args>
         R error_with(R&& r,
-                     char const (&tag)[N1],
+                     source_tag tag,
                      char const (&text)[N2],
                      Arg&& arg,
                      Args&&... args) {
@@ -128,28 +126,28 @@ namespace chronicle {
         }
 
 
-        template<size_t N1, size_t N2>
-        void warning(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void warning(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::warning>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R warning_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R warning_with(R&& r, source_tag tag, char const (&text)[N2]) {
             warning(tag, text);
             return std::forward<R>(r);
         }
 
 
-        template<size_t N1, size_t N2, typename Arg, typename... Args>
-        void warning(char const (&tag)[N1],
+        template<size_t N2, typename Arg, typename... Args>
+        void warning(source_tag tag,
                      char const (&text)[N2],
                      Arg&& arg,
                      Args&&... args) {
             this->template print<severity::warning>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::forward<Arg>(arg),
                 std::forward<Args>(args)...);
@@ -157,12 +155,11 @@ namespace chronicle {
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  typename Arg,
                  typename... Args>
         R warning_with(R&& r,
-                       char const (&tag)[N1],
+                       source_tag tag,
                        char const (&text)[N2],
                        Arg&& arg,
                        Args&&... args) {
@@ -174,28 +171,28 @@ namespace chronicle {
         }
 
 
-        template<size_t N1, size_t N2>
-        void info(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void info(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::info>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R info_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R info_with(R&& r, source_tag tag, char const (&text)[N2]) {
             info(tag, text);
             return std::forward<R>(r);
         }
 
 
-        template<size_t N1, size_t N2, typename Arg, typename... Args>
-        void info(char const (&tag)[N1],
+        template<size_t N2, typename Arg, typename... Args>
+        void info(source_tag tag,
                   char const (&text)[N2],
                   Arg&& arg,
                   Args&&... args) {
             this->template print<severity::info>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::forward<Arg>(arg),
                 std::forward<Args>(args)...);
@@ -203,12 +200,11 @@ namespace chronicle {
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  typename Arg,
                  typename... Args>
         R info_with(R&& r,
-                    char const (&tag)[N1],
+                    source_tag tag,
                     char const (&text)[N2],
                     Arg&& arg,
                     Args&&... args) {
@@ -220,28 +216,50 @@ namespace chronicle {
         }
 
 
-        template<size_t N1, size_t N2>
-        void extra(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        completion info_durable(source_tag tag,
+                                char const (&text)[N2]) {
+            return base::template print_durable<severity::info>(
+                tag,
+                std::string_view {text, N2 - 1});
+        }
+
+
+        template<size_t N2, typename Arg, typename... Args>
+        completion info_durable(source_tag tag,
+                                char const (&text)[N2],
+                                Arg&& arg,
+                                Args&&... args) {
+            return this->template print_durable<severity::info>(
+                tag,
+                std::string_view {text, N2 - 1},
+                std::forward<Arg>(arg),
+                std::forward<Args>(args)...);
+        }
+
+
+        template<size_t N2>
+        void extra(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::extra>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R extra_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R extra_with(R&& r, source_tag tag, char const (&text)[N2]) {
             extra(tag, text);
             return std::forward<R>(r);
         }
 
 
-        template<size_t N1, size_t N2, typename Arg, typename... Args>
-        void extra(char const (&tag)[N1],
+        template<size_t N2, typename Arg, typename... Args>
+        void extra(source_tag tag,
                    char const (&text)[N2],
                    Arg&& arg,
                    Args&&... args) {
             this->template print<severity::extra>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::forward<Arg>(arg),
                 std::forward<Args>(args)...);
@@ -249,12 +267,11 @@ namespace chronicle {
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  typename Arg,
                  typename... Args>
         R extra_with(R&& r,
-                     char const (&tag)[N1],
+                     source_tag tag,
                      char const (&text)[N2],
                      Arg&& arg,
                      Args&&... args) {
@@ -266,28 +283,28 @@ namespace chronicle {
         }
 
 
-        template<size_t N1, size_t N2>
-        void trace(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void trace(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::trace>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R trace_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R trace_with(R&& r, source_tag tag, char const (&text)[N2]) {
             trace(tag, text);
             return std::forward<R>(r);
         }
 
 
-        template<size_t N1, size_t N2, typename Arg, typename... Args>
-        void trace(char const (&tag)[N1],
+        template<size_t N2, typename Arg, typename... Args>
+        void trace(source_tag tag,
                    char const (&text)[N2],
                    Arg&& arg,
                    Args&&... args) {
             this->template print<severity::trace>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::forward<Arg>(arg),
                 std::forward<Args>(args)...);
@@ -295,12 +312,11 @@ namespace chronicle {
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  typename Arg,
                  typename... Args>
         R trace_with(R&& r,
-                     char const (&tag)[N1],
+                     source_tag tag,
                      char const (&text)[N2],
                      Arg&& arg,
                      Args&&... args) {
@@ -314,27 +330,26 @@ namespace chronicle {
 #ifdef NDEBUG
 
 
-        template<size_t N1, size_t N2>
-        void debug(char const (&)[N1], char const (&)[N2]) {}
+        template<size_t N2>
+        void debug(source_tag, char const (&)[N2]) {}
 
 
-        template<typename R, size_t N1, size_t N2>
-        R debug_with(R&& r, char const (&)[N1], char const (&)[N2]) {
+        template<typename R, size_t N2>
+        R debug_with(R&& r, source_tag, char const (&)[N2]) {
             return std::forward<R>(r);
         }
 
 
-        template<size_t N1, size_t N2, typename Arg, typename... Args>
-        void debug(char const (&)[N1], char const (&)[N2], Arg&&, Args&&...) {}
+        template<size_t N2, typename Arg, typename... Args>
+        void debug(source_tag, char const (&)[N2], Arg&&, Args&&...) {}
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  typename Arg,
                  typename... Args>
         R debug_with(R&& r,
-                     char const (&)[N1],
+                     source_tag,
                      char const (&)[N2],
                      Arg&&,
                      Args&&...) {
@@ -344,28 +359,28 @@ namespace chronicle {
 
 #else
 
-        template<size_t N1, size_t N2>
-        void debug(char const (&tag)[N1], char const (&text)[N2]) {
+        template<size_t N2>
+        void debug(source_tag tag, char const (&text)[N2]) {
             base::template print<severity::debug>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1});
         }
 
 
-        template<typename R, size_t N1, size_t N2>
-        R debug_with(R&& r, char const (&tag)[N1], char const (&text)[N2]) {
+        template<typename R, size_t N2>
+        R debug_with(R&& r, source_tag tag, char const (&text)[N2]) {
             debug(tag, text);
             return std::forward<R>(r);
         }
 
 
-        template<size_t N1, size_t N2, typename Arg, typename... Args>
-        void debug(char const (&tag)[N1],
+        template<size_t N2, typename Arg, typename... Args>
+        void debug(source_tag tag,
                    char const (&text)[N2],
                    Arg&& arg,
                    Args&&... args) {
             this->template print<severity::debug>(
-                std::string_view {tag, N1 - 1},
+                tag,
                 std::string_view {text, N2 - 1},
                 std::forward<Arg>(arg),
                 std::forward<Args>(args)...);
@@ -373,15 +388,14 @@ namespace chronicle {
 
 
         template<typename R,
-                 size_t N1,
                  size_t N2,
                  typename Arg,
                  typename... Args>
-        void debug(R&& r,
-                   char const (&tag)[N1],
-                   char const (&text)[N2],
-                   Arg&& arg,
-                   Args&&... args) {
+        R debug_with(R&& r,
+                     source_tag tag,
+                     char const (&text)[N2],
+                     Arg&& arg,
+                     Args&&... args) {
             debug(tag,
                   text,
                   std::forward<Arg>(arg),
@@ -394,21 +408,51 @@ namespace chronicle {
 
     private:
         template<chronicle::severity S, typename Arg, typename... Args>
-        void print(std::string_view const& tag,
+        void print(source_tag const& tag,
                    std::string_view const& text,
                    Arg&& arg,
                    Args&&... args) {
-            if(base::severity() < S)
+            message_type* m = compose<S>(tag,
+                                         text,
+                                         std::forward<Arg>(arg),
+                                         std::forward<Args>(args)...);
+            if(!m)
                 return;
+            base::publish(*m);
+        }
+
+
+        template<chronicle::severity S, typename Arg, typename... Args>
+        completion print_durable(source_tag const& tag,
+                                 std::string_view const& text,
+                                 Arg&& arg,
+                                 Args&&... args) {
+            message_type* m = compose<S>(tag,
+                                         text,
+                                         std::forward<Arg>(arg),
+                                         std::forward<Args>(args)...);
+            if(!m)
+                return {};
+            return base::publish_durable(*m);
+        }
+
+
+        template<chronicle::severity S, typename Arg, typename... Args>
+        message_type* compose(source_tag const& tag,
+                              std::string_view const& text,
+                              Arg&& arg,
+                              Args&&... args) {
+            if(base::threshold() < S)
+                return nullptr;
             message_type* m = base::template claim<S>(tag, text);
             if(!m)
-                return;
+                return nullptr;
             m->data.clear();
             format_args(m->data,
                         std::forward<Arg>(arg),
                         std::forward<Args>(args)...);
             m->has_data = true;
-            base::publish(*m);
+            return m;
         }
 
 
@@ -3,7 +3,9 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <utility>
 
@@ -22,12 +24,18 @@ namespace hydra {
         using queue_type = Q;
         using size_type = typename Q::size_type;
         using batch_type = batch<Q>;
+        using clock_type = std::chrono::steady_clock;
+        using time_point = typename clock_type::time_point;
 
     private:
         std::thread worker_;
         queue_type messages_;
         std::atomic_uint32_t new_message_;
         std::atomic_flag stopping_ {};
+        // Producers take the mutex only when the worker is sleeping
+        std::atomic_bool sleeping_ {false};
+        std::mutex mutex_;
+        std::condition_variable wakeup_;
 
     public:
         activity() noexcept = default;
@@ -39,12 +47,21 @@ namespace hydra {
         message_type& operator[](sequence n) noexcept { return messages_[n]; }
         void reserve(size_type n) noexcept { messages_.reserve(n); }
 
+        // Published messages left in the queue, for draining them when
+        // the worker can't run (e.g. from a fatal signal handler)
+        batch_type pending() noexcept { return batch_type {messages_}; }
+
         
         size_type blocks_count() const noexcept {
             return messages_.blocks_count();
         }
 
 
+        size_type claimed_count() const noexcept {
+            return size_type(messages_.claimed_count());
+        }
+
+
         template<typename Rep, typename Period>
         sequence claim_for(
             std::chrono::duration<Rep, Period> const& duration) noexcept {
@@ -54,8 +71,9 @@ namespace hydra {
 
         void publish(sequence n) noexcept {
             messages_.publish(n);
-            new_message_.fetch_add(1, std::memory_order_relaxed);
-            new_message_.notify_one();
+            new_message_.fetch_add(1);
+            if(sleeping_.load())
+                wake_up();
         }
 
 
@@ -65,21 +83,34 @@ namespace hydra {
             if(is_stopped_or_stopping)
                 return;
             stopping_.test_and_set(std::memory_order_relaxed);
-            new_message_.fetch_add(1, std::memory_order_relaxed);
-            new_message_.notify_one();
+            new_message_.fetch_add(1);
+            wake_up();
             worker_.join();
         }
 
 
         template<typename H>
         bool run(H&& handler) {
+            return run(std::forward<H>(handler),
+                       []() noexcept { return time_point::max(); });
+        }
+
+
+        // Timer is called on the worker after every wake-up and returns
+        // the moment it wants to be called again (time_point::max() for
+        // never). The worker sleeps until a message is published or the
+        // deadline comes, whichever is first.
+        template<typename H, typename T>
+        bool run(H&& handler, T&& timer) {
             if(worker_.joinable() || !messages_)
                 return false;
 
-            worker_ = std::thread {[handler, this]() {
+            worker_ = std::thread {[handler, timer, this]() mutable {
+                auto deadline = time_point::max();
                 while(!stopping_.test(std::memory_order_relaxed)) {
-                    new_message_.wait(0);
+                    wait_until(deadline);
                     process(handler);
+                    deadline = timer();
                 }
                 process(handler);
                 new_message_.store(0, std::memory_order_relaxed);
@@ -91,6 +122,27 @@ namespace hydra {
 
     private:
 
+        // 'sleeping_' is set before checking for messages and producers
+        // check it after adding one (both sequentially consistent), so
+        // either the worker sees the message or the producer wakes it up
+        void wait_until(time_point deadline) {
+            auto lock = std::unique_lock {mutex_};
+            sleeping_.store(true);
+            auto const woken = [this] { return new_message_.load() != 0; };
+            if(deadline == time_point::max())
+                wakeup_.wait(lock, woken);
+            else
+                wakeup_.wait_until(lock, deadline, woken);
+            sleeping_.store(false, std::memory_order_relaxed);
+        }
+
+
+        void wake_up() noexcept {
+            auto const lock = std::lock_guard {mutex_};
+            wakeup_.notify_one();
+        }
+
+
         template<typename H>
         void process(H&& handler) {
             while(messages_.size() != 0) {
@@ -86,6 +86,12 @@ namespace hydra {
         }
 
 
+        // Sequences claimed since construction
+        sequence_value claimed_count() const noexcept {
+            return producer_.load(std::memory_order_relaxed);
+        }
+
+
         void clear_blocks_count() noexcept {
             blocks_count_.store(0, std::memory_order_relaxed);
         }
@@ -5,6 +5,7 @@
 #pragma once
 
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <thread>
@@ -28,7 +29,8 @@ namespace hydra {
         sequence_value index_mask_ {0};
         std::unique_ptr<T[]> pool_;
         std::unique_ptr<sequence_value[]> published_;
-        sequence_value producer_ {0};
+        // Written by producer only, atomic to be read by consumer and stats
+        std::atomic<sequence_value> producer_ {0};
         sequence_value consumer_ {0};
         size_type blocks_count_ {0};
 
@@ -40,20 +42,27 @@ namespace hydra {
         size_type blocks_count() const noexcept { return blocks_count_; }
         void clear_blocks_count() noexcept { blocks_count_ = 0; }
         size_type size() const noexcept {
-            return size_type(producer_ - consumer_);
+            return size_type(producer_.load(std::memory_order_relaxed)
+                             - consumer_);
         }
         size_type capacity() const noexcept { return capacity_; }
 
 
+        // Sequences claimed since construction
+        sequence_value claimed_count() const noexcept {
+            return producer_.load(std::memory_order_relaxed);
+        }
+
+
         spsc_queue(spsc_queue&& other) noexcept
             : capacity_ {other.capacity_},
               index_mask_ {other.index_mask_},
               pool_ {std::move(other.pool_)},
               published_ {std::move(other.published_)},
-              producer_ {other.producer_},
+              producer_ {other.producer_.load(std::memory_order_relaxed)},
               consumer_ {other.consumer_} {
             other.capacity_ = 0;
-            other.producer_ = 0;
+            other.producer_.store(0, std::memory_order_relaxed);
             other.consumer_ = 0;
         }
 
@@ -64,8 +73,9 @@ namespace hydra {
             index_mask_ = other.index_mask_;
             pool_ = std::move(other.pool_);
             published_ = std::move(other.published_);
-            producer_ = other.producer_;
-            other.producer_ = 0;
+            producer_.store(other.producer_.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+            other.producer_.store(0, std::memory_order_relaxed);
             consumer_ = other.consumer_;
             other.consumer_ = 0;
             return *this;
@@ -97,7 +107,8 @@ namespace hydra {
             if(!pool_)
                 return sequence{};
 
-            sequence const p {producer_++};
+            sequence const p {producer_.load(std::memory_order_relaxed)};
+            producer_.store(p.value() + 1, std::memory_order_relaxed);
             if(p.value() - consumer_ < capacity_)
                 return p;
 
@@ -117,8 +128,8 @@ namespace hydra {
             if(!pool_)
                 return sequence{};
 
-            sequence const p{producer_};
-            ++producer_;
+            sequence const p{producer_.load(std::memory_order_relaxed)};
+            producer_.store(p.value() + 1, std::memory_order_relaxed);
 
             if(p.value() - consumer_ < capacity_)
                 return p;
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include <ufmt/print.hpp>
+
+#include "merge.hpp"
+
+
+// Merges chronicle text logs ordered by time into a single one:
+//   chronicle-merge [-o output] [-w window MiB] file...
+// Lines that don't start with severity and time (prologue, multiline
+// text) stay with the record above them. Records with equal time keep
+// the order of files on the command line.
+
+
+int main(int argc, char** argv) {
+    std::uint64_t window_size = 64 << 20;
+    FILE* output = stdout;
+    std::vector<std::string_view> paths;
+
+    for(int i = 1; i != argc; ++i) {
+        auto const option = std::string_view {argv[i]};
+        auto const has_value = i + 1 != argc;
+        if(option == "-o" && has_value) {
+            auto const path = std::string_view {argv[++i]};
+            output = std::fopen(path.data(), "wb");
+            if(!output)
+                return ufmt::error_with(-1, "error: unable to open ", path);
+        } else if(option == "-w" && has_value)
+            window_size = std::max(1, std::atoi(argv[++i])) * (1ull << 20);
+        else if(!option.empty() && option[0] == '-')
+            return ufmt::error_with(-1, "error: unknown option ", option);
+        else
+            paths.push_back(option);
+    }
+    if(paths.empty())
+        return ufmt::error_with(
+            -1, "usage: chronicle-merge [-o output] [-w window MiB] file...");
+
+    std::vector<chronicle::merge::input> inputs(paths.size());
+    for(std::size_t i = 0; i != paths.size(); ++i)
+        if(auto const ec = inputs[i].open(paths[i], window_size); ec)
+            return ufmt::error_with(-1, "error: ", paths[i], ": ", ec.message());
+
+    auto const ec = chronicle::merge::merge(inputs, output);
+    if(output != stdout)
+        std::fclose(output);
+    if(ec)
+        return ufmt::error_with(-1, "error: ", ec.message());
+    return 0;
+}
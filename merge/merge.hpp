@@ -0,0 +1,154 @@
+#pragma once
+
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <chronicle/mapped_file.hpp>
+#include <chronicle/text_line.hpp>
+
+
+namespace chronicle::merge {
+
+
+    class input {
+        std::filesystem::path path_;
+        std::uint64_t file_size_ {0};
+        std::uint64_t window_size_ {0};
+        std::uint64_t window_offset_ {0};
+        chronicle::mapped_file window_;
+        std::uint64_t position_ {0};
+        std::string_view record_;
+        std::string_view time_;
+
+    public:
+        std::error_code open(std::filesystem::path path,
+                             std::uint64_t window_size) {
+            path_ = std::move(path);
+            window_size_ = window_size;
+            std::error_code ec;
+            file_size_ = std::filesystem::file_size(path_, ec);
+            if(ec)
+                return ec;
+            return remap(0);
+        }
+
+
+        std::string_view record() const noexcept { return record_; }
+        std::string_view time() const noexcept { return time_; }
+
+
+        // Record stays valid until the next call
+        bool next(std::error_code& ec) {
+            position_ += record_.size();
+            record_ = {};
+            if(position_ >= file_size_)
+                return false;
+            for(;;) {
+                auto const data = window_.view().substr(
+                    std::size_t(position_ - window_offset_));
+                auto const whole =
+                    window_offset_ + window_.size() == file_size_;
+                auto const size = record_size(data, whole);
+                if(size != 0) {
+                    record_ = data.substr(0, size);
+                    chronicle::text_line parsed;
+                    time_ = chronicle::text_line::parse(first_line(record_), parsed)
+                              ? parsed.time
+                              : std::string_view {};
+                    return true;
+                }
+                // Record is cut by the end of window
+                if(window_offset_ == position_)
+                    window_size_ *= 2;
+                if(ec = remap(position_); ec)
+                    return false;
+            }
+        }
+
+    private:
+        std::error_code remap(std::uint64_t offset) {
+            window_ = {};
+            auto mapped = chronicle::mapped_file::open(path_, offset, window_size_);
+            if(!mapped)
+                return mapped.error();
+            window_ = std::move(*mapped);
+            window_offset_ = offset;
+            return {};
+        }
+
+
+        static std::string_view first_line(std::string_view text) noexcept {
+            return text.substr(0, text.find('\n'));
+        }
+
+
+        // Zero if more data is needed to find where the record ends
+        static std::size_t record_size(std::string_view data, bool whole) {
+            auto end = data.find('\n');
+            if(end == std::string_view::npos)
+                return whole ? data.size() : 0;
+            ++end;
+            chronicle::text_line parsed;
+            while(end != data.size()) {
+                auto line_end = data.find('\n', end);
+                if(line_end == std::string_view::npos) {
+                    if(!whole)
+                        return 0;
+                    line_end = data.size();
+                }
+                if(chronicle::text_line::parse(data.substr(end, line_end - end),
+                                               parsed))
+                    return end;
+                end = line_end == data.size() ? line_end : line_end + 1;
+            }
+            return whole ? end : 0;
+        }
+
+    };   // input
+
+
+    // Records with equal time keep the order of 'inputs'
+    inline std::error_code merge(std::vector<input>& inputs, FILE* output) {
+        constexpr std::size_t output_chunk = 1 << 20;
+        auto const later = [&](std::size_t x, std::size_t y) {
+            auto const tx = inputs[x].time();
+            auto const ty = inputs[y].time();
+            return tx != ty ? tx > ty : x > y;
+        };
+        std::priority_queue<std::size_t,
+                            std::vector<std::size_t>,
+                            decltype(later)>
+            heap {later};
+
+        std::error_code ec;
+        for(std::size_t i = 0; i != inputs.size(); ++i)
+            if(inputs[i].next(ec))
+                heap.push(i);
+
+        std::string buffer;
+        buffer.reserve(output_chunk + (1 << 16));
+        while(!heap.empty() && !ec) {
+            auto const i = heap.top();
+            heap.pop();
+            buffer += inputs[i].record();
+            if(buffer.size() >= output_chunk) {
+                std::fwrite(buffer.data(), 1, buffer.size(), output);
+                buffer.clear();
+            }
+            if(inputs[i].next(ec))
+                heap.push(i);
+        }
+        std::fwrite(buffer.data(), 1, buffer.size(), output);
+        return ec;
+    }
+
+
+}   // namespace chronicle::merge
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <chronicle/mapped_file.hpp>
+#include <chronicle/text_line.hpp>
+
+#include <ufmt/print.hpp>
+
+#include "query.hpp"
+
+
+// Filters chronicle text logs in parallel:
+//   chronicle-query [-l severity] [-s source] [-f time] [-t time]
+//                   [-g text] [-j jobs] file...
+// Times are prefixes of the logged ones, e.g. "2020-05-09 16:57",
+// 'from' is inclusive and 'to' is exclusive.
+
+
+int main(int argc, char** argv) {
+    // Output of a chunk is buffered whole, so chunks are of fixed size
+    constexpr std::size_t chunk_size = 1 << 20;
+    namespace query = chronicle::query;
+    query::filter f;
+    auto jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<chronicle::mapped_file> files;
+
+    for(int i = 1; i != argc; ++i) {
+        auto const option = std::string_view {argv[i]};
+        auto const has_value = i + 1 != argc;
+        if(option == "-l" && has_value) {
+            char marker;
+            auto const severity = std::string_view {argv[++i]};
+            if(!chronicle::text_line::marker_of(severity, marker))
+                return ufmt::error_with(-1, "error: unknown severity ", severity);
+            f.level = chronicle::text_line::rank(marker);
+        } else if(option == "-s" && has_value)
+            f.source = argv[++i];
+        else if(option == "-f" && has_value)
+            f.from = argv[++i];
+        else if(option == "-t" && has_value)
+            f.to = argv[++i];
+        else if(option == "-g" && has_value)
+            f.pattern = argv[++i];
+        else if(option == "-j" && has_value)
+            jobs = unsigned(std::max(1, std::atoi(argv[++i])));
+        else if(!option.empty() && option[0] == '-')
+            return ufmt::error_with(-1, "error: unknown option ", option);
+        else {
+            auto mapped = chronicle::mapped_file::open(argv[i]);
+            if(!mapped)
+                return ufmt::error_with(
+                    -1, "error: ", option, ": ", mapped.error().message());
+            files.push_back(std::move(*mapped));
+        }
+    }
+    if(files.empty())
+        return ufmt::error_with(-1,
+                                "usage: chronicle-query [-l severity] "
+                                "[-s source] [-f time] [-t time] [-g text] "
+                                "[-j jobs] file...");
+
+    std::vector<query::chunk> chunks;
+    for(auto const& file: files)
+        query::split(file.view(), chunk_size, chunks);
+    query::run(chunks, f, jobs, stdout);
+    return 0;
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <chronicle/text_line.hpp>
+
+
+namespace chronicle::query {
+
+
+    // Chunks are scanned ahead of output at most this many per job
+    constexpr unsigned chunks_ahead = 4;
+
+
+    struct filter {
+        int level {-1};
+        std::string source;
+        std::string from;
+        std::string to;
+        std::string pattern;
+
+
+        bool parsing() const noexcept {
+            return level != -1 || !source.empty() || !from.empty()
+                || !to.empty();
+        }
+
+
+        bool accepts(std::string_view line) const noexcept {
+            if(!parsing())
+                return true;
+            chronicle::text_line parsed;
+            if(!chronicle::text_line::parse(line, parsed))
+                return false;
+            if(level != -1 && chronicle::text_line::rank(parsed.marker) > level)
+                return false;
+            if(!source.empty() && parsed.source != source)
+                return false;
+            if(!from.empty() && parsed.time.substr(0, from.size()) < from)
+                return false;
+            if(!to.empty() && parsed.time.substr(0, to.size()) >= to)
+                return false;
+            return true;
+        }
+
+    };   // filter
+
+
+    struct chunk {
+        std::string_view data;
+        std::string output;
+        bool done {false};
+    };   // chunk
+
+
+    // glibc memchr and memmem are vectorized
+    inline std::size_t search(std::string_view text,
+                              std::string_view pattern) noexcept {
+#if defined(__GLIBC__)
+        auto const* found =
+            ::memmem(text.data(), text.size(), pattern.data(), pattern.size());
+        return found ? std::size_t(static_cast<char const*>(found) - text.data())
+                     : std::string_view::npos;
+#else
+        return text.find(pattern);
+#endif
+    }
+
+
+    inline std::size_t line_end(std::string_view text,
+                                std::size_t from) noexcept {
+        auto const* found =
+            std::memchr(text.data() + from, '\n', text.size() - from);
+        return found ? std::size_t(static_cast<char const*>(found) - text.data())
+                     : text.size();
+    }
+
+
+    inline void scan(chunk& c, filter const& f) {
+        auto rest = c.data;
+        while(!rest.empty()) {
+            std::size_t begin = 0;
+            if(!f.pattern.empty()) {
+                auto const at = search(rest, f.pattern);
+                if(at == std::string_view::npos)
+                    return;
+                auto const previous = rest.rfind('\n', at);
+                begin = previous == std::string_view::npos ? 0 : previous + 1;
+            }
+            auto const end = line_end(rest, begin);
+            auto const line = rest.substr(begin, end - begin);
+            if(f.accepts(line)) {
+                c.output += line;
+                c.output += '\n';
+            }
+            rest.remove_prefix(std::min(rest.size(), end + 1));
+        }
+    }
+
+
+    // Chunks end at the first line end after 'chunk_size'
+    inline void split(std::string_view data,
+                      std::size_t chunk_size,
+                      std::vector<chunk>& chunks) {
+        while(!data.empty()) {
+            auto const end = chunk_size >= data.size()
+                               ? data.size()
+                               : std::min(data.size(),
+                                          line_end(data, chunk_size) + 1);
+            chunks.push_back(chunk {data.substr(0, end), {}, false});
+            data.remove_prefix(end);
+        }
+    }
+
+
+    // Output keeps order of the input, at most 'jobs * chunks_ahead' chunks
+    // are buffered
+    inline void run(std::vector<chunk>& chunks,
+                    filter const& f,
+                    unsigned jobs,
+                    FILE* output) {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::condition_variable written;
+        std::size_t flushed = 0;
+        std::atomic<std::size_t> next {0};
+        std::size_t const ahead = std::size_t(jobs) * chunks_ahead;
+        std::vector<std::thread> workers;
+        for(unsigned j = 0; j != std::min<std::size_t>(jobs, chunks.size());
+            ++j)
+            workers.emplace_back([&] {
+                for(auto i = next++; i < chunks.size(); i = next++) {
+                    {
+                        std::unique_lock lock {mutex};
+                        written.wait(lock, [&] { return i < flushed + ahead; });
+                    }
+                    scan(chunks[i], f);
+                    {
+                        std::lock_guard lock {mutex};
+                        chunks[i].done = true;
+                    }
+                    done.notify_all();
+                }
+            });
+
+        for(auto& c: chunks) {
+            {
+                std::unique_lock lock {mutex};
+                done.wait(lock, [&] { return c.done; });
+            }
+            std::fwrite(c.output.data(), 1, c.output.size(), output);
+            std::string {}.swap(c.output);
+            {
+                std::lock_guard lock {mutex};
+                ++flushed;
+            }
+            written.notify_all();
+        }
+
+        for(auto& worker: workers)
+            worker.join();
+    }
+
+
+}   // namespace chronicle::query
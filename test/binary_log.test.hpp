@@ -0,0 +1,152 @@
+#pragma once
+
+
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "doctest.h"
+
+#include <chronicle/binary_log.hpp>
+#include <chronicle/binary_reader.hpp>
+#include <chronicle/fields/format.hpp>
+#include <chronicle/fields/severity_marker.hpp>
+#include <chronicle/fields/source.hpp>
+#include <chronicle/mapped_file.hpp>
+#include <chronicle/sinks/daily_rotated_file.hpp>
+#include <chronicle/sinks/file.hpp>
+
+
+TEST_SUITE("binary_log") {
+
+    TEST_CASE("decodes records") {
+        namespace fs = std::filesystem;
+        using untimed = chronicle::fields::format<chronicle::fields::severity_marker,
+                                                  chronicle::fields::source>;
+        fs::remove("test-binary.log");
+        auto const started = std::chrono::system_clock::now();
+        for(int session = 0; session != 2; ++session) {
+            chronicle::unique_binary_log target;
+            REQUIRE(target.open(chronicle::sinks::file::open("test-binary.log")));
+            target.info("test", "started");
+            for(int i = 0; i != 2; ++i)
+                target.warning("test", "value ", -i, ' ', 7u, ' ', true);
+            using chronicle::binary::literal;
+            char buffer[] = "mutable";
+            char const fixed[32] = "fixed";
+            target.error("io", "failed ", std::string {"write"}, ' ', 0.5);
+            target.info("io", "pair", literal {" a="}, 1, " b=", buffer);
+            buffer[0] = 'M';
+            target.info("io", "pair", literal {" a="}, 2, " b=", buffer);
+            target.info("io", "array ", fixed, '.');
+            target.close();
+        }
+
+        auto const mapped = chronicle::mapped_file::open("test-binary.log");
+        REQUIRE(!!mapped);
+        chronicle::binary_reader reader;
+        reader.feed(mapped->view());
+        chronicle::binary_record record;
+        std::error_code ec;
+        ufmt::text decoded;
+        while(reader.next(record, ec)) {
+            REQUIRE(record.time >= started - std::chrono::microseconds {1});
+            REQUIRE(record.time <= std::chrono::system_clock::now());
+            chronicle::binary_reader::render<untimed>(record, decoded);
+        }
+        REQUIRE(!ec);
+
+        auto const session = std::string {"    [test] started\n"
+                                          "[W] [test] value 0 7 1\n"
+                                          "[W] [test] value -1 7 1\n"
+                                          "[E] [io] failed write 0.5\n"
+                                          "    [io] pair a=1 b=mutable\n"
+                                          "    [io] pair a=2 b=Mutable\n"
+                                          "    [io] array fixed.\n"};
+        REQUIRE(std::string {decoded.data(), decoded.size()}
+                == session + session);
+        fs::remove("test-binary.log");
+    }
+
+
+    TEST_CASE("decodes rotated part alone") {
+        namespace fs = std::filesystem;
+        auto const directory =
+            fs::temp_directory_path() / "chronicle-test-binary-rotation";
+        fs::remove_all(directory);
+        {
+            chronicle::unique_binary_log target;
+            REQUIRE(target.open(chronicle::sinks::daily_rotated_file::open(
+                directory / "test.log", 4096)));
+            using chronicle::binary::literal;
+            auto const padding = std::string(40, '.');
+            for(int i = 0; i != 400; ++i) {
+                if(i % 10 == 0)
+                    std::this_thread::sleep_for(std::chrono::milliseconds {1});
+                if(i % 2 == 0)
+                    target.info("test", "even ", i, literal {" of"}, padding);
+                else
+                    target.warning("test", "odd ", i, ' ', padding);
+            }
+            target.close();
+        }
+
+        // Parts are named "test-2020_05_09.log", "test-2020_05_09-02.log"...
+        std::vector<fs::path> parts;
+        for(auto const& entry: fs::directory_iterator {directory})
+            parts.push_back(entry.path());
+        std::sort(parts.begin(), parts.end(), [](auto const& l, auto const& r) {
+            auto const ls = l.stem().string(), rs = r.stem().string();
+            return ls.size() != rs.size() ? ls.size() < rs.size() : ls < rs;
+        });
+        REQUIRE(parts.size() > 2);
+
+        auto const decode = [](chronicle::binary_reader& reader,
+                               fs::path const& path,
+                               ufmt::text& decoded) {
+            auto const mapped = chronicle::mapped_file::open(path);
+            REQUIRE(!!mapped);
+            reader.feed(mapped->view());
+            chronicle::binary_record record;
+            std::error_code ec;
+            while(reader.next(record, ec))
+                chronicle::binary_reader::render(record, decoded);
+            REQUIRE(!ec);
+        };
+
+        ufmt::text together;
+        chronicle::binary_reader reader;
+        for(auto const& part: parts)
+            decode(reader, part, together);
+        ufmt::text alone;
+        for(auto const& part: parts) {
+            chronicle::binary_reader part_reader;
+            decode(part_reader, part, alone);
+        }
+
+        REQUIRE(together.view() == alone.view());
+        auto const view = alone.view();
+        REQUIRE(std::count(view.begin(), view.end(), '\n') == 400);
+        REQUIRE(view.find("[test] even 398 of.....") != std::string_view::npos);
+        REQUIRE(view.find("[test] odd 399 .....") != std::string_view::npos);
+        fs::remove_all(directory);
+    }
+
+
+    TEST_CASE("rejects truncated record") {
+        chronicle::binary_reader reader;
+        auto const data = std::string {chronicle::binary::session_header}
+                        + std::string {"\x00\x01\x01x\x01y\x01\x03\x0B", 9};
+        reader.feed(data);
+        chronicle::binary_record record;
+        std::error_code ec;
+        REQUIRE(!reader.next(record, ec));
+        REQUIRE(ec == std::errc::illegal_byte_sequence);
+    }
+
+}
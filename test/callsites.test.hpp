@@ -0,0 +1,79 @@
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "doctest.h"
+
+#include <chronicle/callsites.hpp>
+
+
+TEST_SUITE("callsites") {
+
+    // Literal texts of distinct callsites, "n000", "n001", ...
+    template<std::size_t I>
+    struct numbered {
+        static constexpr char text[] = {'n',
+                                        char('0' + I / 100 % 10),
+                                        char('0' + I / 10 % 10),
+                                        char('0' + I % 10),
+                                        '\0'};
+    };
+
+
+    template<std::size_t... I>
+    std::vector<std::uint32_t> intern_numbered(std::index_sequence<I...>) {
+        return {chronicle::callsites::intern_literal("test",
+                                                     numbered<I>::text)...};
+    }
+
+
+    TEST_CASE("intern") {
+        namespace callsites = chronicle::callsites;
+        auto const id = callsites::intern_literal("test", "interned");
+        REQUIRE(id != callsites::none);
+        REQUIRE(callsites::intern_literal("test", "interned") == id);
+        auto const copy = std::string {"interned"};
+        REQUIRE(callsites::intern("test", copy) == id);
+        REQUIRE(callsites::intern("test", "other") != id);
+        REQUIRE(callsites::get(id).prefix == "[test] interned");
+        REQUIRE(callsites::get(callsites::none).text.empty());
+    }
+
+
+    TEST_CASE("intern_literal of many callsites") {
+        auto const callsites = std::make_index_sequence<600> {};
+        auto const ids = intern_numbered(callsites);
+        REQUIRE(std::set<std::uint32_t> {ids.begin(), ids.end()}.size()
+                == ids.size());
+        REQUIRE(intern_numbered(callsites) == ids);
+        REQUIRE(chronicle::callsites::get(ids.back()).text == "n599");
+    }
+
+
+    TEST_CASE("intern_literal beyond initial table") {
+        namespace callsites = chronicle::callsites;
+        constexpr auto count = callsites::detail::initial_literals;
+        static char texts[count][8];
+        std::vector<std::uint32_t> ids;
+        for(std::size_t i = 0; i != count; ++i) {
+            std::snprintf(texts[i], sizeof(texts[i]), "g%05zu", i);
+            ids.push_back(callsites::intern_literal("test", texts[i]));
+        }
+        REQUIRE(std::set<std::uint32_t> {ids.begin(), ids.end()}.size()
+                == count);
+        auto again = std::vector<std::uint32_t> {};
+        for(auto const& text: texts)
+            again.push_back(callsites::intern_literal("test", text));
+        REQUIRE(again == ids);
+        REQUIRE(callsites::get(ids.back()).text == "g08191");
+        REQUIRE(callsites::detail::literals.load()->size > count);
+    }
+
+}
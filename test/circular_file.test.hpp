@@ -0,0 +1,71 @@
+#pragma once
+
+
+#if !defined(_WIN32)
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include <chronicle/sinks/circular_file.hpp>
+
+#include "doctest.h"
+
+
+TEST_SUITE("circular_file") {
+    TEST_CASE("circular_file::write") {
+        std::filesystem::remove("test-circular.log");
+        auto expected_target =
+            chronicle::sinks::circular_file::open("test-circular.log", 16);
+        REQUIRE(!!expected_target);
+        auto& target = **expected_target;
+        auto const now = std::chrono::system_clock::now();
+        target.write(now, "first\n", 6);
+        REQUIRE(*chronicle::sinks::circular_file::read("test-circular.log")
+                == "first\n");
+        target.write(now, "second\nthird\n", 13);
+        target.close();
+        REQUIRE(std::filesystem::file_size("test-circular.log")
+                == chronicle::sinks::circular_file::data_offset + 16);
+        REQUIRE(*chronicle::sinks::circular_file::read("test-circular.log")
+                == "second\nthird\n");
+    }
+
+
+    TEST_CASE("circular_file::read keeps line starting at aligned wrap") {
+        std::filesystem::remove("test-circular.log");
+        auto expected_target =
+            chronicle::sinks::circular_file::open("test-circular.log", 16);
+        REQUIRE(!!expected_target);
+        auto& target = **expected_target;
+        auto const now = std::chrono::system_clock::now();
+        target.write(now, "1234567\nabcdefg\n", 16);
+        target.write(now, "ABCDEFG\n", 8);
+        target.close();
+        REQUIRE(*chronicle::sinks::circular_file::read("test-circular.log")
+                == "abcdefg\nABCDEFG\n");
+    }
+
+
+    TEST_CASE("circular_file::open continues from head") {
+        std::filesystem::remove("test-circular.log");
+        auto const now = std::chrono::system_clock::now();
+        {
+            auto expected_target =
+                chronicle::sinks::circular_file::open("test-circular.log", 16);
+            REQUIRE(!!expected_target);
+            (*expected_target)->write(now, "first\nsecond\n", 13);
+        }
+        auto expected_target =
+            chronicle::sinks::circular_file::open("test-circular.log", 16);
+        REQUIRE(!!expected_target);
+        (*expected_target)->write(now, "third\n", 6);
+        (*expected_target)->close();
+        REQUIRE(*chronicle::sinks::circular_file::read("test-circular.log")
+                == "second\nthird\n");
+    }
+
+
+}
+
+#endif
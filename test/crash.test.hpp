@@ -0,0 +1,219 @@
+#pragma once
+
+
+#if defined(__linux__) || defined(__APPLE__)
+
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chronicle/sinks/file.hpp>
+#include <chronicle/text_log.hpp>
+
+#include "doctest.h"
+
+
+// Never returns from writing a batch with "stuck"
+struct stuck_sink: chronicle::sink {
+    int fd;
+
+
+    explicit stuck_sink(char const* path) noexcept
+        : fd {::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)} {}
+
+
+    bool ready() const noexcept override { return fd != -1; }
+
+
+    void write(time_point const&, char const* data, size_type size) noexcept
+        override {
+        if(std::string_view {data, size}.find("stuck") != std::string_view::npos)
+            for(;;)
+                ::pause();
+        ::write(fd, data, size);
+    }
+
+
+    void flush() noexcept override {}
+    void close() noexcept override {}
+    int crash_descriptor() noexcept override { return fd; }
+    void prologue(char const*, size_t) noexcept override {}
+    void epilogue(char const*, size_t) noexcept override {}
+};   // stuck_sink
+
+
+inline int overflow_stack(int depth) {
+    volatile char frame[1024];
+    frame[0] = char(depth);
+    if(depth == -1)   // never, keeps the recursion from being infinite
+        return 0;
+    return overflow_stack(depth + 1) + frame[0];
+}
+
+
+TEST_SUITE("crash") {
+    TEST_CASE("drain_on_crash") {
+        std::filesystem::remove("test-crash.log");
+
+        auto const child = ::fork();
+        REQUIRE(child != -1);
+
+        if(child == 0) {
+            std::signal(SIGABRT, SIG_DFL);   // skip doctest reporting
+            chronicle::shared_text_log target;
+            if(!target.open(chronicle::sinks::file::open("test-crash.log"),
+                            1 << 16)
+               || !target.drain_on_crash())
+                ::_exit(1);
+            for(int i = 0; i != 10000; ++i)
+                target.info("test", "message ", i);
+            std::abort();
+        }
+
+        int status = 0;
+        REQUIRE(::waitpid(child, &status, 0) == child);
+        REQUIRE(WIFSIGNALED(status));
+        REQUIRE(WTERMSIG(status) == SIGABRT);
+
+        std::ifstream stream {"test-crash.log", std::ios::binary};
+        auto const content = std::string {std::istreambuf_iterator<char> {stream},
+                                          std::istreambuf_iterator<char> {}};
+        auto const last = content.find("message 9999\n");
+        auto const marker = content.find("++++ log crashed, signal ");
+        REQUIRE(last != std::string::npos);
+        REQUIRE(marker != std::string::npos);
+        REQUIRE(last < marker);
+    }
+
+
+    TEST_CASE("drain_on_crash with attached sink") {
+        std::filesystem::remove("test-crash-main.log");
+        std::filesystem::remove("test-crash-warnings.log");
+
+        auto const child = ::fork();
+        REQUIRE(child != -1);
+
+        if(child == 0) {
+            std::signal(SIGABRT, SIG_DFL);
+            chronicle::shared_text_log target;
+            if(!target.attach(
+                   chronicle::sinks::file::open("test-crash-warnings.log"),
+                   chronicle::severity::warning)
+               || !target.open(
+                   chronicle::sinks::file::open("test-crash-main.log"),
+                   1 << 16)
+               || !target.drain_on_crash())
+                ::_exit(1);
+            for(int i = 0; i != 10000; ++i)
+                if(i % 100 == 99)
+                    target.warning("test", "warning ", i);
+                else
+                    target.info("test", "message ", i);
+            std::abort();
+        }
+
+        int status = 0;
+        REQUIRE(::waitpid(child, &status, 0) == child);
+        REQUIRE(WIFSIGNALED(status));
+        REQUIRE(WTERMSIG(status) == SIGABRT);
+
+        auto const read = [](char const* path) {
+            std::ifstream stream {path, std::ios::binary};
+            return std::string {std::istreambuf_iterator<char> {stream},
+                                std::istreambuf_iterator<char> {}};
+        };
+        auto const main = read("test-crash-main.log");
+        auto const warnings = read("test-crash-warnings.log");
+        auto const marker = "++++ log crashed, signal ";
+        REQUIRE(main.find("message 9998\n") < main.find(marker));
+        REQUIRE(main.find("warning 9999\n") < main.find(marker));
+        REQUIRE(warnings.find("warning 9999\n") < warnings.find(marker));
+        REQUIRE(warnings.find(marker) != std::string::npos);
+        REQUIRE(warnings.find("message ") == std::string::npos);
+    }
+
+
+    TEST_CASE("drain_on_crash after stack overflow") {
+        std::filesystem::remove("test-overflow.log");
+
+        auto const child = ::fork();
+        REQUIRE(child != -1);
+
+        if(child == 0) {
+            // Drop doctest handler and its alternate stack
+            std::signal(SIGSEGV, SIG_DFL);
+            stack_t disabled {};
+            disabled.ss_flags = SS_DISABLE;
+            ::sigaltstack(&disabled, nullptr);
+            chronicle::shared_text_log target;
+            if(!target.open(chronicle::sinks::file::open("test-overflow.log"),
+                            1 << 16)
+               || !target.drain_on_crash())
+                ::_exit(1);
+            for(int i = 0; i != 1000; ++i)
+                target.info("test", "message ", i);
+            ::_exit(overflow_stack(0));
+        }
+
+        int status = 0;
+        REQUIRE(::waitpid(child, &status, 0) == child);
+        REQUIRE(WIFSIGNALED(status));
+        REQUIRE(WTERMSIG(status) == SIGSEGV);
+
+        std::ifstream stream {"test-overflow.log", std::ios::binary};
+        auto const content = std::string {std::istreambuf_iterator<char> {stream},
+                                          std::istreambuf_iterator<char> {}};
+        auto const last = content.find("message 999\n");
+        auto const marker = content.find("++++ log crashed, signal ");
+        REQUIRE(last != std::string::npos);
+        REQUIRE(marker != std::string::npos);
+        REQUIRE(last < marker);
+    }
+
+
+    TEST_CASE("drain_on_crash with busy backend") {
+        auto const child = ::fork();
+        REQUIRE(child != -1);
+
+        if(child == 0) {
+            std::signal(SIGABRT, SIG_DFL);
+            chronicle::shared_text_log target;
+            auto sink = std::make_unique<stuck_sink>("test-busy.log");
+            if(!target.open(chronicle::expected_sink_ptr {std::move(sink)})
+               || !target.drain_on_crash())
+                ::_exit(1);
+            target.info("test", "before");
+            std::this_thread::sleep_for(std::chrono::milliseconds {20});
+            target.info("test", "stuck");
+            std::this_thread::sleep_for(std::chrono::milliseconds {20});
+            target.info("test", "pending");
+            std::abort();
+        }
+
+        int status = 0;
+        REQUIRE(::waitpid(child, &status, 0) == child);
+        REQUIRE(WIFSIGNALED(status));
+        REQUIRE(WTERMSIG(status) == SIGABRT);
+
+        std::ifstream stream {"test-busy.log", std::ios::binary};
+        auto const content = std::string {std::istreambuf_iterator<char> {stream},
+                                          std::istreambuf_iterator<char> {}};
+        REQUIRE(content.find("before") != std::string::npos);
+        REQUIRE(content.find("backend is busy") != std::string::npos);
+        REQUIRE(content.find("pending") == std::string::npos);
+    }
+}
+
+
+#endif
@@ -2,6 +2,10 @@
 
 
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
 
 #include <chronicle/sinks/daily_rotated_file.hpp>
 
@@ -23,4 +27,151 @@ TEST_SUITE("daily_rotated_file") {
     }
 
 
+    TEST_CASE("daily_rotated_file::write rotates by limit") {
+        namespace fs = std::filesystem;
+        auto const directory =
+            fs::temp_directory_path() / "chronicle-test-rotation";
+        fs::remove_all(directory);
+        auto expected_target =
+            chronicle::sinks::daily_rotated_file::open(directory / "test.log",
+                                                       4096);
+        REQUIRE(!!expected_target);
+        auto& target = **expected_target;
+        auto const line = std::string(99, 'x') + '\n';
+        auto const now = std::chrono::system_clock::now();
+        for(int i = 0; i != 200; ++i)
+            target.write(now, line.data(), line.size());
+        target.close();
+
+        auto files = 0;
+        auto total = std::uintmax_t {0};
+        for(auto const& entry: fs::directory_iterator {directory}) {
+            ++files;
+            REQUIRE(entry.file_size() <= 4096);
+            total += entry.file_size();
+        }
+        REQUIRE(files > 1);
+        REQUIRE(total == 200 * line.size());
+        fs::remove_all(directory);
+    }
+
+
+    TEST_CASE("daily_rotated_file::write compresses rotated files") {
+        namespace fs = std::filesystem;
+        auto const directory =
+            fs::temp_directory_path() / "chronicle-test-compression";
+        fs::remove_all(directory);
+        auto expected_target = chronicle::sinks::daily_rotated_file::open(
+            directory / "test.log",
+            4096,
+            chronicle::sinks::compression::gzip);
+        REQUIRE(!!expected_target);
+        auto& target = **expected_target;
+        auto const line = std::string(99, 'x') + '\n';
+        auto const now = std::chrono::system_clock::now();
+        for(int i = 0; i != 200; ++i)
+            target.write(now, line.data(), line.size());
+        target.close();
+
+        auto plain = 0;
+        auto compressed = 0;
+        for(auto const& entry: fs::directory_iterator {directory}) {
+            auto const extension = entry.path().extension();
+            if(extension == ".log")
+                ++plain;
+            else if(extension == ".gz")
+                ++compressed;
+            else
+                FAIL("unexpected file " << entry.path());
+        }
+        REQUIRE(plain == 1);
+        REQUIRE(compressed > 1);
+        fs::remove_all(directory);
+    }
+
+
+    TEST_CASE("daily_rotated_file::write removes files beyond retention") {
+        namespace fs = std::filesystem;
+        using namespace std::chrono_literals;
+        auto const directory =
+            fs::temp_directory_path() / "chronicle-test-retention";
+        fs::remove_all(directory);
+        fs::create_directories(directory);
+        for(auto const name: {"test-2000_01_01.log", "test-other.log"}) {
+            std::ofstream {directory / name} << "old\n";
+            fs::last_write_time(directory / name,
+                                fs::file_time_type::clock::now() - 48h);
+        }
+
+        auto expected_target = chronicle::sinks::daily_rotated_file::open(
+            directory / "test.log",
+            4096,
+            chronicle::sinks::compression::none,
+            chronicle::sinks::retention {.files = 2, .age = 24h});
+        REQUIRE(!!expected_target);
+        auto& target = **expected_target;
+        auto const line = std::string(99, 'x') + '\n';
+        auto const now = std::chrono::system_clock::now();
+        for(int i = 0; i != 200; ++i)
+            target.write(now, line.data(), line.size());
+        target.close();
+
+        auto dated = 0;
+        for(auto const& entry: fs::directory_iterator {directory})
+            if(entry.path().filename().string().starts_with("test-2"))
+                ++dated;
+        REQUIRE(dated == 3);
+        REQUIRE(!fs::exists(directory / "test-2000_01_01.log"));
+        REQUIRE(fs::exists(directory / "test-other.log"));
+        fs::remove_all(directory);
+    }
+
+
+    TEST_CASE("daily_rotated_file::write swaps in file prepared before midnight") {
+        namespace fs = std::filesystem;
+        namespace chr = std::chrono;
+        using namespace std::chrono_literals;
+        auto const directory =
+            fs::temp_directory_path() / "chronicle-test-midnight";
+        fs::remove_all(directory);
+        auto expected_target =
+            chronicle::sinks::daily_rotated_file::open(directory / "test.log");
+        REQUIRE(!!expected_target);
+        auto& target = **expected_target;
+        auto const midnight =
+            chr::floor<chr::days>(chr::system_clock::now()) + chr::days {1};
+        auto const today = std::string {"today\n"};
+        auto const tomorrow = std::string {"tomorrow\n"};
+
+        // Within prepare_lead housekeeper opens the next day file
+        target.write(midnight - 30s, today.data(), today.size());
+        target.flush();
+        std::this_thread::sleep_for(100ms);
+        auto prepared = fs::path {};
+        auto files = 0;
+        for(auto const& entry: fs::directory_iterator {directory}) {
+            ++files;
+            if(entry.file_size() == 0)
+                prepared = entry.path();
+        }
+        REQUIRE(files == 2);
+        REQUIRE(!prepared.empty());
+
+        // Prepared handle keeps writing to the removed file, a file
+        // opened by backend would appear again
+        fs::remove(prepared);
+        target.write(midnight + 1s, tomorrow.data(), tomorrow.size());
+        target.close();
+
+        REQUIRE(!fs::exists(prepared));
+        files = 0;
+        for(auto const& entry: fs::directory_iterator {directory}) {
+            ++files;
+            REQUIRE(entry.file_size() == today.size());
+        }
+        REQUIRE(files == 1);
+        fs::remove_all(directory);
+    }
+
+
 }
@@ -1,6 +1,14 @@
 #pragma once
 
 
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
 #include "doctest.h"
 
 #include <chronicle/data_log.hpp>
@@ -50,6 +58,101 @@ TEST_SUITE("data_log") {
     }
 
 
+    TEST_CASE("data_log::flush_policy") {
+        auto const read_all = [](char const* path) {
+            std::ifstream stream {path, std::ios::binary};
+            return std::string {std::istreambuf_iterator<char> {stream},
+                                std::istreambuf_iterator<char> {}};
+        };
+        using namespace std::chrono_literals;
+
+        SUBCASE("interval") {
+            std::filesystem::remove("test-interval.log");
+            chronicle::shared_data_log<std::string> target(256);
+            target.flush_policy(chronicle::flush_policy::every(5ms));
+            REQUIRE(target.open(chronicle::sinks::file::open("test-interval.log")));
+            target.info("test", "info", "interval");
+            std::this_thread::sleep_for(100ms);
+            REQUIRE(read_all("test-interval.log").find("interval")
+                    != std::string::npos);
+        }
+
+        SUBCASE("bytes") {
+            std::filesystem::remove("test-bytes.log");
+            chronicle::shared_data_log<std::string> target(256);
+            target.flush_policy(chronicle::flush_policy::every(0ms, 1));
+            REQUIRE(target.open(chronicle::sinks::file::open("test-bytes.log")));
+            target.info("test", "info", "bytes");
+            std::this_thread::sleep_for(100ms);
+            REQUIRE(read_all("test-bytes.log").find("bytes")
+                    != std::string::npos);
+        }
+
+        SUBCASE("sync on error") {
+            std::filesystem::remove("test-sync.log");
+            chronicle::shared_data_log<std::string> target(256);
+            target.flush_policy(chronicle::flush_policy::durable(1h, 1ms));
+            REQUIRE(target.open(chronicle::sinks::file::open("test-sync.log")));
+            target.info("test", "info", "before");
+            target.error("test", "error", "synced");
+            std::this_thread::sleep_for(100ms);
+            auto const content = read_all("test-sync.log");
+            REQUIRE(content.find("before") != std::string::npos);
+            REQUIRE(content.find("synced") != std::string::npos);
+        }
+    }
+
+
+    TEST_CASE("data_log::info_durable") {
+        std::filesystem::remove("test-durable.log");
+        chronicle::shared_data_log<std::string> target(256);
+        auto const rejected = target.info_durable("test", "info", "rejected");
+        REQUIRE(!rejected);
+        REQUIRE(rejected.ready());
+        REQUIRE(!rejected.wait());
+
+        REQUIRE(target.open(chronicle::sinks::file::open("test-durable.log")));
+        auto const first = target.info_durable("test", "info", "first");
+        auto const second = target.info_durable("test", "info", "second");
+        REQUIRE(!!first);
+        REQUIRE(second.wait());
+        REQUIRE(first.ready());
+
+        std::ifstream stream {"test-durable.log", std::ios::binary};
+        auto const content = std::string {std::istreambuf_iterator<char> {stream},
+                                          std::istreambuf_iterator<char> {}};
+        REQUIRE(content.find("second") != std::string::npos);
+    }
+
+
+    TEST_CASE("data_log::stats") {
+        std::filesystem::remove("test-stats.log");
+        chronicle::shared_data_log<std::string> target(256);
+        target.info("test", "info", "dropped");
+        REQUIRE(target.open(chronicle::sinks::file::open("test-stats.log"), 16));
+        for(int i = 0; i != 100; ++i)
+            target.info("test", "info", "stats");
+        target.close();
+
+        auto const s = target.stats();
+        REQUIRE(s.enqueued == 100);
+        REQUIRE(s.processed == 100);
+        REQUIRE(s.dropped == 1);
+        REQUIRE(s.occupancy == 0);
+        REQUIRE(s.batches != 0);
+        std::uint64_t batches = 0;
+        for(auto const n: s.batch_sizes)
+            batches += n;
+        REQUIRE(batches == s.batches);
+        REQUIRE(s.high_watermark >= 1);
+        // Queue of 16 and the producer waiting for a slot
+        REQUIRE(s.high_watermark <= 16 + 1);
+        REQUIRE(s.bytes_written != 0);
+        REQUIRE(s.bytes_written
+                < std::filesystem::file_size("test-stats.log"));
+    }
+
+
     TEST_CASE("conout") {
         chronicle::shared_data_log<int> target(256);
         auto const opened = target.open(chronicle::sinks::conout::open());
@@ -0,0 +1,75 @@
+#pragma once
+
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../merge/merge.hpp"
+
+#include "doctest.h"
+
+
+TEST_SUITE("merge") {
+    std::string merged(std::vector<std::filesystem::path> const& paths) {
+        std::vector<chronicle::merge::input> inputs(paths.size());
+        for(std::size_t i = 0; i != paths.size(); ++i)
+            REQUIRE(!inputs[i].open(paths[i], 1 << 20));
+        FILE* output = std::tmpfile();
+        REQUIRE(output != nullptr);
+        REQUIRE(!chronicle::merge::merge(inputs, output));
+        std::rewind(output);
+        std::string result(1 << 12, '\0');
+        result.resize(std::fread(result.data(), 1, result.size(), output));
+        std::fclose(output);
+        return result;
+    }
+
+
+    TEST_CASE("merge::merge interleaves by time") {
+        namespace fs = std::filesystem;
+        auto const directory = fs::temp_directory_path() / "chronicle-test-merge";
+        fs::remove_all(directory);
+        fs::create_directories(directory);
+        std::ofstream {directory / "a.log"} << "    10:00:01.000 a1\n"
+                                               "    10:00:03.000 a3\n"
+                                               "  continuation of a3\n"
+                                               "    10:00:05.000 a5\n";
+        std::ofstream {directory / "b.log"} << "    10:00:02.000 b2\n"
+                                               "[E] 10:00:04.000 b4\n"
+                                               "    10:00:06.000 b6";
+
+        REQUIRE(merged({directory / "a.log", directory / "b.log"})
+                == "    10:00:01.000 a1\n"
+                   "    10:00:02.000 b2\n"
+                   "    10:00:03.000 a3\n"
+                   "  continuation of a3\n"
+                   "[E] 10:00:04.000 b4\n"
+                   "    10:00:05.000 a5\n"
+                   "    10:00:06.000 b6");
+        fs::remove_all(directory);
+    }
+
+
+    TEST_CASE("merge::merge keeps order of files for equal time") {
+        namespace fs = std::filesystem;
+        auto const directory = fs::temp_directory_path() / "chronicle-test-ties";
+        fs::remove_all(directory);
+        fs::create_directories(directory);
+        std::ofstream {directory / "a.log"} << "    10:00:01.000 a\n"
+                                               "    10:00:01.000 a\n";
+        std::ofstream {directory / "b.log"} << "    10:00:01.000 b\n";
+
+        REQUIRE(merged({directory / "a.log", directory / "b.log"})
+                == "    10:00:01.000 a\n"
+                   "    10:00:01.000 a\n"
+                   "    10:00:01.000 b\n");
+        REQUIRE(merged({directory / "b.log", directory / "a.log"})
+                == "    10:00:01.000 b\n"
+                   "    10:00:01.000 a\n"
+                   "    10:00:01.000 a\n");
+        fs::remove_all(directory);
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../query/query.hpp"
+
+#include "doctest.h"
+
+
+TEST_SUITE("query") {
+    TEST_CASE("query::filter by time range") {
+        chronicle::query::filter target;
+        target.from = "2020-05-09 16:58";
+        target.to = "2020-05-09 17:00";
+        REQUIRE(!target.accepts("    2020-05-09 16:57:59.999999 [net] before"));
+        REQUIRE(target.accepts("    2020-05-09 16:58:00.000000 [net] from"));
+        REQUIRE(target.accepts("    2020-05-09 16:59:59.999999 [net] within"));
+        REQUIRE(!target.accepts("    2020-05-09 17:00:00.000000 [net] to"));
+        REQUIRE(!target.accepts("  continuation"));
+    }
+
+
+    TEST_CASE("query::filter by severity") {
+        chronicle::query::filter target;
+        char marker;
+        REQUIRE(chronicle::text_line::marker_of("warning", marker));
+        target.level = chronicle::text_line::rank(marker);
+        REQUIRE(target.accepts("[F] 2020-05-09 16:57:02.343402 failure"));
+        REQUIRE(target.accepts("[E] 2020-05-09 16:57:02.343402 error"));
+        REQUIRE(target.accepts("[W] 2020-05-09 16:57:02.343402 warning"));
+        REQUIRE(!target.accepts("    2020-05-09 16:57:02.343402 info"));
+        REQUIRE(!target.accepts("[D] 2020-05-09 16:57:02.343402 debug"));
+    }
+
+
+    TEST_CASE("query::run keeps order of input") {
+        namespace query = chronicle::query;
+        std::string input;
+        std::string expected;
+        for(int i = 0; i != 1000; ++i) {
+            auto const error = i % 3 == 0;
+            auto const line = std::string {error ? "[E] " : "    "}
+                            + "16:57:02.343 [main] line "
+                            + std::to_string(i) + '\n';
+            input += line;
+            if(error)
+                expected += line;
+        }
+        query::filter f;
+        f.level = chronicle::text_line::rank('E');
+        std::vector<query::chunk> chunks;
+        query::split(input, 256, chunks);
+        REQUIRE(chunks.size() > query::chunks_ahead * 4);
+
+        FILE* output = std::tmpfile();
+        REQUIRE(output != nullptr);
+        query::run(chunks, f, 4, output);
+        std::rewind(output);
+        std::string actual(expected.size() + 1, '\0');
+        actual.resize(std::fread(actual.data(), 1, actual.size(), output));
+        std::fclose(output);
+        REQUIRE(actual == expected);
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+
+#include <csignal>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <chronicle/sinks/file.hpp>
+#include <chronicle/sinks/ring.hpp>
+#include <chronicle/text_log.hpp>
+
+#include "doctest.h"
+
+
+TEST_SUITE("ring") {
+    TEST_CASE("flight_recorder::write") {
+        chronicle::sinks::flight_recorder target {16};
+        target.write("first\n", 6);
+        REQUIRE(target.snapshot() == "first\n");
+        target.write("second\nthird\n", 13);
+        REQUIRE(target.size() == 16);
+        REQUIRE(target.snapshot() == "second\nthird\n");
+        target.clear();
+        REQUIRE(target.snapshot().empty());
+    }
+
+
+    TEST_CASE("flight_recorder::snapshot keeps line starting at aligned wrap") {
+        chronicle::sinks::flight_recorder target {16};
+        target.write("1234567\nabcdefg\n", 16);
+        REQUIRE(target.snapshot() == "1234567\nabcdefg\n");
+        target.write("ABCDEFG\n", 8);
+        REQUIRE(target.snapshot() == "abcdefg\nABCDEFG\n");
+    }
+
+
+    TEST_CASE("ring keeps messages below log severity") {
+        std::filesystem::remove("test-main.log");
+        auto const recorder =
+            std::make_shared<chronicle::sinks::flight_recorder>(4096);
+        chronicle::shared_text_log target;
+        REQUIRE(target.attach(chronicle::sinks::ring::open(recorder),
+                              chronicle::severity::trace));
+        REQUIRE(target.open(chronicle::sinks::file::open("test-main.log")));
+        target.info("test", "info", " regular");
+        target.trace("test", "trace", " detailed");
+        target.close();
+
+        auto const recorded = recorder->snapshot();
+        REQUIRE(recorded.find("regular") != std::string::npos);
+        REQUIRE(recorded.find("detailed") != std::string::npos);
+
+        std::ifstream stream {"test-main.log", std::ios::binary};
+        auto const written = std::string {std::istreambuf_iterator<char> {stream},
+                                          std::istreambuf_iterator<char> {}};
+        REQUIRE(written.find("regular") != std::string::npos);
+        REQUIRE(written.find("detailed") == std::string::npos);
+    }
+
+
+#if !defined(_WIN32)
+    TEST_CASE("flight_recorder::dump_on") {
+        std::filesystem::remove("test-dump.log");
+        chronicle::sinks::flight_recorder target {1024};
+        target.write("recorded\n", 9);
+        REQUIRE(!target.dump_on(SIGUSR2, "test-dump.log"));
+        std::raise(SIGUSR2);
+        for(int i = 0; i != 100 && !std::filesystem::exists("test-dump.log"); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds {10});
+        std::this_thread::sleep_for(std::chrono::milliseconds {10});
+        target.stop_dumping();
+        std::ifstream stream {"test-dump.log", std::ios::binary};
+        auto const dumped = std::string {std::istreambuf_iterator<char> {stream},
+                                         std::istreambuf_iterator<char> {}};
+        REQUIRE(dumped == "recorded\n");
+    }
+#endif
+}
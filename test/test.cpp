@@ -1,7 +1,16 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include "binary_log.test.hpp"
+#include "callsites.test.hpp"
+#include "circular_file.test.hpp"
+#include "crash.test.hpp"
 #include "daily_rotated_file.test.hpp"
 #include "data_log.test.hpp"
+#include "merge.test.hpp"
+#include "query.test.hpp"
+#include "ring.test.hpp"
 #include "structured_log.test.hpp"
+#include "text_line.test.hpp"
 #include "text_log.test.hpp"
+#include "time_index.test.hpp"
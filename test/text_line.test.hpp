@@ -0,0 +1,36 @@
+#pragma once
+
+
+#include <chronicle/text_line.hpp>
+
+#include "doctest.h"
+
+
+TEST_SUITE("text_line") {
+    TEST_CASE("text_line::parse multithreaded") {
+        chronicle::text_line target;
+        REQUIRE(chronicle::text_line::parse(
+            "[E] 2020-05-09 16:57:02.343402 #14648 [main] Some message",
+            target));
+        REQUIRE(target.marker == 'E');
+        REQUIRE(target.time == "2020-05-09 16:57:02.343402");
+        REQUIRE(target.thread == "14648");
+        REQUIRE(target.source == "main");
+        REQUIRE(target.text == "Some message");
+    }
+
+
+    TEST_CASE("text_line::parse singlethreaded time only") {
+        chronicle::text_line target;
+        REQUIRE(chronicle::text_line::parse("    16:57:02.343 [main] Message",
+                                            target));
+        REQUIRE(target.marker == ' ');
+        REQUIRE(target.time == "16:57:02.343");
+        REQUIRE(target.thread.empty());
+        REQUIRE(target.source == "main");
+        REQUIRE(target.text == "Message");
+        REQUIRE(!chronicle::text_line::parse("continued line", target));
+    }
+
+
+}
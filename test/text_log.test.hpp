@@ -1,9 +1,22 @@
 #pragma once
 
 
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
 #include "doctest.h"
 
+#include <chronicle/fields/file_line.hpp>
+#include <chronicle/fields/format.hpp>
+#include <chronicle/fields/function.hpp>
+#include <chronicle/fields/source.hpp>
 #include <chronicle/sinks/conout.hpp>
+#include <chronicle/sinks/file.hpp>
 #include <chronicle/text_log.hpp>
 
 TEST_SUITE("text_log") {
@@ -29,4 +42,135 @@ TEST_SUITE("text_log") {
         auto const n = 0xFFFFFFFFFFFFFFFFull;
         target.info("test", "info", std::uint64_t(n));
     }
+
+
+    TEST_CASE("info_durable to terminal") {
+        chronicle::shared_text_log target;
+        target.open(chronicle::sinks::conout::open());
+        REQUIRE(target.info_durable("test", "durable", ' ', 42).wait());
+    }
+
+
+    TEST_CASE("backtrace") {
+        std::filesystem::remove("test-backtrace.log");
+        chronicle::shared_text_log target;
+        target.backtrace(2, chronicle::severity::trace);
+        REQUIRE(target.open(chronicle::sinks::file::open("test-backtrace.log")));
+        target.trace("test", "trace", " first");
+        target.trace("test", "trace", " second");
+        target.trace("test", "trace", " third");
+        target.info("test", "info", " regular");
+        target.error("test", "error", " failed");
+        target.trace("test", "trace", " dropped");
+        target.close();
+
+        std::ifstream stream {"test-backtrace.log", std::ios::binary};
+        auto const content = std::string {std::istreambuf_iterator<char> {stream},
+                                          std::istreambuf_iterator<char> {}};
+        REQUIRE(content.find("first") == std::string::npos);
+        auto const second = content.find("second");
+        auto const third = content.find("third");
+        auto const regular = content.find("regular");
+        auto const failed = content.find("failed");
+        REQUIRE(regular != std::string::npos);
+        REQUIRE(regular < second);
+        REQUIRE(second < third);
+        REQUIRE(third < failed);
+        REQUIRE(content.find("dropped") == std::string::npos);
+    }
+
+
+    TEST_CASE("backtrace goes to attached sinks accepting the error") {
+        std::filesystem::remove("test-backtrace.log");
+        std::filesystem::remove("test-errors.log");
+        chronicle::shared_text_log target;
+        target.backtrace(2, chronicle::severity::trace);
+        REQUIRE(target.attach(chronicle::sinks::file::open("test-errors.log"),
+                              chronicle::severity::error));
+        REQUIRE(target.open(chronicle::sinks::file::open("test-backtrace.log")));
+        target.trace("test", "trace", " kept");
+        target.warning("test", "warning", " skipped");
+        target.error("test", "error", " failed");
+        target.close();
+
+        auto const read = [](char const* path) {
+            std::ifstream stream {path, std::ios::binary};
+            return std::string {std::istreambuf_iterator<char> {stream},
+                                std::istreambuf_iterator<char> {}};
+        };
+        auto const content = read("test-backtrace.log");
+        auto const errors = read("test-errors.log");
+        REQUIRE(content.find("kept") < content.find("failed"));
+        REQUIRE(content.find("failed") != std::string::npos);
+        REQUIRE(errors.find("kept") < errors.find("failed"));
+        REQUIRE(errors.find("failed") != std::string::npos);
+        REQUIRE(errors.find("skipped") == std::string::npos);
+    }
+
+
+    TEST_CASE("file and line of the call") {
+        namespace fields = chronicle::fields;
+        using located_format =
+            fields::format<fields::file_line, fields::function, fields::source>;
+        std::filesystem::remove("test-located.log");
+        chronicle::text_log<chronicle::traits_unique<ufmt::text,
+                                                     located_format,
+                                                     std::chrono::system_clock>>
+            target;
+        REQUIRE(target.open(chronicle::sinks::file::open("test-located.log")));
+        auto const line = __LINE__ + 2;
+        for(int i = 0; i != 2; ++i)
+            target.info("test", "located ", i);
+        target.info("test", "located ", 2);
+        target.close();
+
+        std::ifstream stream {"test-located.log", std::ios::binary};
+        auto const content = std::string {std::istreambuf_iterator<char> {stream},
+                                          std::istreambuf_iterator<char> {}};
+        auto const at = [](int l) {
+            return std::string {"text_log.test.hpp:"} + std::to_string(l) + ' ';
+        };
+        REQUIRE(content.find(at(line)) != std::string::npos);
+        REQUIRE(content.find(at(line + 1)) != std::string::npos);
+        REQUIRE(content.find("[test] located 0\n") != std::string::npos);
+        REQUIRE(content.find("[test] located 2\n") != std::string::npos);
+        REQUIRE(content.find("DOCTEST_ANON_FUNC") != std::string::npos);
+    }
+
+
+    TEST_CASE("queue residence") {
+        using namespace std::chrono_literals;
+        std::filesystem::remove("test-residence.log");
+        chronicle::shared_text_log target;
+        target.self_report(10ms);
+        REQUIRE(target.open(chronicle::sinks::file::open("test-residence.log")));
+        std::this_thread::sleep_for(5ms);   // clock calibration
+        for(int i = 0; i != 100; ++i)
+            target.info("test", "residence ", i);
+        std::this_thread::sleep_for(50ms);
+        target.close();
+
+        auto const s = target.stats();
+        std::uint64_t waited = 0;
+        for(auto const n: s.residence)
+            waited += n;
+        REQUIRE(waited == 100);
+        REQUIRE(s.residence_percentile(50.) <= s.residence_percentile(100.));
+        REQUIRE(s.max_residence <= s.residence_percentile(100.));
+
+        std::ifstream stream {"test-residence.log", std::ios::binary};
+        auto const content = std::string {std::istreambuf_iterator<char> {stream},
+                                          std::istreambuf_iterator<char> {}};
+        REQUIRE(content.find("[chronicle] queue residence { messages: ")
+                != std::string::npos);
+        // Reports have the longest wait of their interval
+        std::uint64_t reported_max = 0;
+        auto const key = std::string {"max_ns: "};
+        for(auto at = content.find(key); at != std::string::npos;
+            at = content.find(key, at + key.size()))
+            reported_max = (std::max)(
+                reported_max,
+                std::uint64_t(std::stoull(content.substr(at + key.size()))));
+        REQUIRE(reported_max == std::uint64_t(s.max_residence.count()));
+    }
 }
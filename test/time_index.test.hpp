@@ -0,0 +1,47 @@
+#pragma once
+
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include <chronicle/sinks/file.hpp>
+#include <chronicle/sinks/time_index.hpp>
+
+#include "doctest.h"
+
+
+TEST_SUITE("time_index") {
+    TEST_CASE("map_time_range") {
+        namespace fs = std::filesystem;
+        namespace sinks = chronicle::sinks;
+        using namespace std::chrono_literals;
+        fs::remove("test-indexed.log");
+        fs::remove("test-indexed.log.idx");
+        auto expected_target =
+            sinks::file::open("test-indexed.log", sinks::index_policy::every(1));
+        REQUIRE(!!expected_target);
+        auto& target = **expected_target;
+        auto const t0 = std::chrono::system_clock::now();
+        target.write(t0, "first\n", 6);
+        target.write(t0 + 10s, "second\n", 7);
+        target.write(t0 + 20s, "third\n", 6);
+        target.write(t0 + 30s, "fourth\n", 7);
+        target.close();
+        REQUIRE(fs::file_size("test-indexed.log.idx")
+                == 4 * sizeof(sinks::index_entry));
+
+        auto const range =
+            sinks::map_time_range("test-indexed.log", t0 + 15s, t0 + 16s);
+        REQUIRE(!!range);
+        REQUIRE(range->view() == "second\n");
+
+        auto const tail =
+            sinks::map_time_range("test-indexed.log", t0 + 25s, t0 + 40s);
+        REQUIRE(!!tail);
+        REQUIRE(tail->view() == "third\nfourth\n");
+        fs::remove("test-indexed.log.idx");
+    }
+
+
+}